@@ -1,315 +1,777 @@
-#include <xc.h>
-#include "LoRa.h"
-#include <stdint.h>
-#include <stdio.h>
-
-#define DEBUG 1
-
-/**
- * Configures PIC and LoRa module to start with specified frequency in MHz
- * from PIC18F46K22_LoRA_UVVIS_V2
- */
-void LoRaStart(float freq, uint8_t syncWord){
-    printf("LoRa Start\r\n");
-    //Configure pin for LoRa module reset
-    ANSELAbits.ANSA2=0; //Digital output buffer enabled (analogue function turned off)
-    
-    //Configure SPI2 as master
-    //Set up SPI pins first
-    TRISDbits.RD1=1; //SDIx must have corresponding TRIS bit set (input)
-    TRISDbits.RD4=0; //SDOx must have corresponding TRIS bit cleared (output)
-    TRISDbits.RD0=0; //SCKx (Master mode) must have corresponding TRIS bit cleared (output)
-    TRISDbits.RD3=0; //#SS must have corresponding TRIS bit cleared (output)
-    ANSELDbits.ANSD1=0; //Input buffer enabled
-    ANSELDbits.ANSD4=0; //Digital
-    ANSELDbits.ANSD3=0; //Digital
-    ANSELDbits.ANSD0=0; //Digital
-    LATDbits.LATD3=1; //Set SS high so chip is not selected
-    
-    PMD1bits.MSSP2MD=0; //Turn on MSSP2 module (SPI2)
-    PMD0bits.SPI2MD=0; //Turn on SPI2
-    
-    
-    //Clock polarity
-    SSP2CON1bits.CKP=0; //Clock idle low, active high
-    SSP2STATbits.CKE=1; //Active to idle 1
-    
-    //Input data sampling
-    SSP2STATbits.SMP=1; //Input data sampled at end of data output time 1
-    
-    //SPI Mode and clock
-    SSP2CON1bits.SSPM=0b0010; //SPI Master Mode, clock = Fosc/64
-    
-    //SPI Enable
-    SSP2CON1bits.SSPEN=1; //Enabled
-    
-    //LoRaReset();
-    if(DEBUG){
-        printf("Set LoRa Mode\r\n");
-    }
-    __delay_ms(10);
-    setLoRaMode();
-    __delay_ms(10);
-    if(DEBUG){
-        printf("LoRa load optimal register values\r\n");
-    }
-    LoRaOptimalLoad(syncWord);
-    if(DEBUG){
-        printf("LoRa set frequency\r\n");
-    }
-    LoRaSetFrequency(freq); //Can only set in standby or sleep modes
-}
-
-uint8_t LoRaGetVersion(){
-    uint8_t temp = SPI2ReadByte(VERSION_REG);
-    return temp;
-}
-
-void LoRaReset(){
-    //Perform reset
-    TRISAbits.RA2=0; //Configure port as an output
-    LATAbits.LA2=0; //In reset
-    __delay_ms(1);
-    TRISAbits.RA2=1; //Configure port as input (goes high-Z)
-    __delay_ms(5);
-}
-
-void setLoRaMode(){
-    //Set Long Range Mode bit in OpMode register
-    uint8_t regValue = readOpModeRegister();
-    regValue = regValue | LORA_MODE; //Set bit 7 high and leave others as is
-    writeOpModeRegister(regValue); //Write the value back
-}
-
-uint8_t readOpModeRegister(){
-    return SPI2ReadByte(OP_MODE_REG);
-}
-
-void writeOpModeRegister(uint8_t regValue){
-    SPI2WriteByte(OP_MODE_REG, regValue);
-}
-
-
-
-void LoRaMode_RXActive(){
-    SPI2WriteByte(OP_MODE_REG, 0b1000101); //LoRa Mode with Receiver active all the time
-}
-
-/**
- * SPI2WriteByte
- * Writes an address byte, then writes a data byte
- * @param address
- * @param data
- */
-void SPI2WriteByte(uint8_t address, uint8_t data){
-    SSP2IF=0; //Clear interrupt flag
-    LATDbits.LATD3=0; //Set SS low
-    __delay_us(5);
-    address = address|0x80; //bit 7 set to indicate a register write
-    SSP2BUF=address; //Write address to SPI buffer 
-    while(!SSP2IF){
-        //Wait for transmission to complete
-    }
-    SSP2IF=0; //Clear interrupt flag
-    __delay_us(5);
-    SSP2BUF=data; 
-    while(!SSP2IF){
-        //Wait for transmission and reception to complete
-    }
-    __delay_us(5);
-    LATDbits.LATD3=1; //Set SS high
-    SSP2IF=0; //Clear interrupt flag
-    uint8_t dataByte = SSP2BUF; //A byte has been received but this is not used.
-}
-
-/**
- * SPI2ReadByte
- * Writes an address byte then reads a byte back.  0 is sent as a dummy value
- * for the second transfer.
- * @param address
- * @return 
- */
-uint8_t SPI2ReadByte(uint8_t address){
-    SSP2IF=0; //Clear interrupt flag
-    LATDbits.LATD3=0; //Set SS low
-    SSP2BUF=address; //Write data to SPI buffer
-    while(!SSP2IF){
-        //Wait for transmission to complete
-    }
-    SSP2IF=0; //Clear interrupt flag
-    SSP2BUF=0; //Data byte - for a read, set to 0
-    while(!SSP2IF){
-        //Wait for transmission and reception to complete
-    }
-    SSP2IF=0; //Clear interrupt flag
-    //__delay_us(20);
-    LATDbits.LATD3=1; //Set SS high
-    uint8_t dataByte = SSP2BUF;
-    return dataByte;
-}
-
-/* 
- * Transmits a data packet.
- */
-void LoRaTXData(uint8_t* data, uint8_t dataLength){
-    //Must be in standby mode for this to work
-    LoRaStandbyMode();
-    printf("Transmitting.\r\n");
-    SPI2WriteByte(FIFO_ADD_PTR_REG, 0);
-    SPI2WriteByte(PAYLOAD_LENGTH_REG, 0);
-    
-
-    for(uint8_t i=0;i<dataLength;i++){
-        SPI2WriteByte(FIFO_REG, data[i]);
-    }
-    SPI2WriteByte(PAYLOAD_LENGTH_REG, dataLength);
-    LoRaTXMode(); //Set TX mode to send the message
-    
-    //Will return to standby mode automatically when finished.
-    //You can check TxDone interrupt to see if it's finished.
-}
-
-/**
- * Sets the LoRa module into standby mode
- */
-void LoRaStandbyMode(){
-    uint8_t regValue = readOpModeRegister(); //Read whats in there already
-    regValue = regValue & 0b11111000; //Blank out other modes
-    regValue = regValue | STANDBY_MODE; //Set bit 0 high and leave others as is
-    writeOpModeRegister(regValue); //Write the value back
-}
-
-void LoRaSleepMode(){
-    uint8_t regValue = readOpModeRegister(); //Read whats in there already
-    regValue = regValue & 0b11111000; //Blank out other modes
-    regValue = regValue | SLEEP_MODE;
-    writeOpModeRegister(regValue); //Write the value back
-}
-
-void LoRaFreqSynthRXMode(){
-    uint8_t regValue = readOpModeRegister(); //Read whats in there already
-    regValue = regValue & 0b11111000; //Blank out other modes
-    regValue = regValue | FREQ_SYNTH_RX_MODE; //Set bit 0 high and leave others as is
-    writeOpModeRegister(regValue); //Write the value back
-}
-
-void LoRaFreqSynthTXMode(){
-    uint8_t regValue = readOpModeRegister(); //Read whats in there already
-    regValue = regValue & 0b11111000; //Blank out other modes
-    regValue = regValue | FREQ_SYNTH_TX_MODE; //Set bit 0 high and leave others as is
-    writeOpModeRegister(regValue); //Write the value back
-}
-
-void LoRaTXMode(){
-    printf("TX Mode\r\n");
-    uint8_t regValue = readOpModeRegister(); //Read whats in there already
-    regValue = regValue & 0b11111000; //Blank out other modes
-    regValue = regValue | TX_MODE; //Set bit 0 high and leave others as is
-    writeOpModeRegister(regValue); //Write the value back
-}
-
-void LoRaRXContinuousMode(){
-    uint8_t regValue = readOpModeRegister(); //Read whats in there already
-    regValue = regValue & 0b11111000; //Blank out other modes
-    regValue = regValue | RX_CONT_MODE; //Set bit 0 high and leave others as is
-    writeOpModeRegister(regValue); //Write the value back02
-}
-
-/**
- * Sets the frequency of the LoRa module
- * @param  Frequency in MHz
- * 
- * Frf = XOSC * FreqReg/2^19
- * Resolution is 61.035Hz for XOSC=32MHz.
- */
-void LoRaSetFrequency(float freqMHz){
-    uint32_t intermediate = (freqMHz*16384);
-    //printf("Intermediate %lu\r\n",intermediate);
-    uint8_t msb = (intermediate>>16) & 0xFF; //Extract MSB
-    uint8_t mid = (intermediate>>8)& 0xFF; //Extract mid byte
-    uint8_t lsb = intermediate & 0xFF; //Extract LSB
-    //printf("MSB %d, MID %d, LSB %d\r\n",msb,mid,lsb);
-    SPI2WriteByte(FRF_MSB_REG,msb);
-    SPI2WriteByte(FRF_MID_REG,mid);
-    SPI2WriteByte(FRF_LSB_REG,lsb);
-}
-
-/**
- * Gets the centre frequency from the device.
- * @return Frequency in MHz.
- */
-float LoRaGetFrequency(){
-    uint8_t msb = SPI2ReadByte(FRF_MSB_REG);
-    uint8_t mid = SPI2ReadByte(FRF_MID_REG);
-    uint8_t lsb = SPI2ReadByte(FRF_LSB_REG);
-    uint32_t intermediate = (uint32_t)msb<<16 | (uint32_t)mid<<8 | lsb;
-    float freqMHz = (float)intermediate/16384.0;
-    return freqMHz;
-}
-
-
-uint8_t LoRaGetIRQFlags(){
-    uint8_t regValue = SPI2ReadByte(IRQ_FLAGS_REG);
-    return regValue;
-}
-
-void LoRaClearIRQFlags(){
-    SPI2WriteByte(IRQ_FLAGS_REG,0xFF);
-}
-
-
-/**
- * Dumps the contents of all registers to printf
- */
-void LoRaDumpRegisters(){
-    for(uint8_t reg=0x0;reg<0x20;reg++){
-        printf("Reg %X:%X\r\n", reg, SPI2ReadByte(reg));
-    }
-}
-
-/**
- * Loads all the registers required to setup an optimal configuration
- */
-void LoRaOptimalLoad(uint8_t syncWord){
-    LoRaSleepMode(); //Can only change to LoRa mode in sleep mode
-    setLoRaMode();
-    LoRaStandbyMode();
-    __delay_ms(10); //Need a delay to come up to standby mode
-    SPI2WriteByte(0x06, 0xD9);
-    SPI2WriteByte(0x07, 0);
-    SPI2WriteByte(0x08, 0);
-    SPI2WriteByte(0x09, 0x8F);
-    SPI2WriteByte(0x0A, 0x09);
-    SPI2WriteByte(0x0B, 0x2B);
-    SPI2WriteByte(0x0C, 0x23);
-    SPI2WriteByte(0x0E, 0);
-    SPI2WriteByte(0x0F, 0);
-    SPI2WriteByte(0x10, 0);
-    SPI2WriteByte(0x11, 0);
-    SPI2WriteByte(0x13, 0);
-    SPI2WriteByte(0x1D, 0x72);
-    SPI2WriteByte(0x1E, 0x70);
-    SPI2WriteByte(0x1F, 0x64);
-    SPI2WriteByte(0x20, 0);
-    SPI2WriteByte(0x21, 0x08);
-    SPI2WriteByte(0x23, 0xFF);
-    SPI2WriteByte(0x24, 0);
-    SPI2WriteByte(0x25, 0);
-    SPI2WriteByte(0x26, 0x04);
-    SPI2WriteByte(0x2F, 0x45);
-    SPI2WriteByte(0x30, 0x55);
-    SPI2WriteByte(0x31, 0xC3);
-    SPI2WriteByte(0x33, 0x27);
-    SPI2WriteByte(0x36, 0x03);
-    SPI2WriteByte(0x37, 0x0A);
-    SPI2WriteByte(0x39, syncWord); //Sync word was 0x12
-    SPI2WriteByte(0x3A, 0x49);
-    SPI2WriteByte(0x4B, 0x09);
-    SPI2WriteByte(0x4D, 0x84);
-    SPI2WriteByte(0x61, 0x1C);
-    SPI2WriteByte(0x62, 0x0E);
-    SPI2WriteByte(0x63, 0x5B);
-    SPI2WriteByte(0x64, 0xCC);
-    SPI2WriteByte(0x70, 0xD0);
-}
-
+#include "LoRa.h"
+#include "LoRaHAL.h"
+#include "LoRaProfile.h"
+#include "log.h"
+#include <stdint.h>
+
+/*
+ * RAM shadow of the registers the driver touches most.  Every write through
+ * SPI2WriteByte/SPI2WriteBurst keeps it up to date, so mode changes and
+ * repeated settings need no read back and unchanged values are not
+ * rewritten.  A slot is only trusted once it has been written or read since
+ * the last reset; LoRaShadowResync() reloads it all from the module.
+ */
+#define SHADOW_SLOTS 10
+static const uint8_t shadowRegs[SHADOW_SLOTS] = {
+    OP_MODE_REG, FRF_MSB_REG, FRF_MID_REG, FRF_LSB_REG, PA_CONFIG_REG,
+    MODEM_CONFIG_1_REG, MODEM_CONFIG_2_REG, PAYLOAD_LENGTH_REG, MODEM_CONFIG_3_REG,
+    DIO_MAPPING_1_REG
+};
+static uint8_t shadowValues[SHADOW_SLOTS];
+static uint16_t shadowValid; //Bit per slot
+
+/**
+ * Configures PIC and LoRa module to start with specified frequency
+ * from PIC18F46K22_LoRA_UVVIS_V2
+ * @param frf frequency register value, use LORA_FRF(Hz)
+ * @param syncWord
+ */
+void LoRaStart(uint32_t frf, uint8_t syncWord){
+    LOG_DEBUG(("LoRa Start\r\n"));
+    TRACE(TRACE_LORA_START, syncWord);
+    LoRaHALInit(); //Configure SPI2 and the reset pin
+    
+    //LoRaReset();
+    LOG_DEBUG(("LoRa load optimal register values\r\n"));
+    LoRaOptimalLoad(syncWord);
+    LOG_DEBUG(("LoRa set frequency\r\n"));
+    LoRaSetFRF(frf); //Can only set in standby or sleep modes
+}
+
+uint8_t LoRaGetVersion(){
+    uint8_t temp = SPI2ReadByte(VERSION_REG);
+    return temp;
+}
+
+void LoRaReset(){
+    //Perform reset
+    LoRaHALResetAssert(); //In reset
+    LORA_DELAY_US(LORA_T_RESET_PULSE_US);
+    LoRaHALResetRelease(); //Reset line goes high-Z
+    LORA_DELAY_US(LORA_T_RESET_READY_US);
+    shadowValid = 0; //Registers are back at their reset values
+}
+
+void setLoRaMode(){
+    //Set Long Range Mode bit in OpMode register
+    uint8_t regValue = readOpModeRegister();
+    regValue = regValue | LORA_MODE; //Set bit 7 high and leave others as is
+    writeOpModeRegister(regValue); //Write the value back
+}
+
+uint8_t readOpModeRegister(){
+    return LoRaReadRegister(OP_MODE_REG);
+}
+
+/**
+ * Writes the op mode register unless it already holds regValue.
+ * TX, RX single and CAD end on their own, so the module may have moved on
+ * from what the shadow says; those are always written.
+ */
+void writeOpModeRegister(uint8_t regValue){
+    uint8_t mode = regValue & 0b00000111;
+    TRACE(TRACE_LORA_MODE, regValue);
+    if(mode == TX_MODE || mode == RX_SINGLE_MODE || mode == CAD_MODE){
+        SPI2WriteByte(OP_MODE_REG, regValue);
+    }
+    else{
+        LoRaWriteRegister(OP_MODE_REG, regValue);
+    }
+}
+
+/**
+ * Writes the op mode register until it reads back as regValue, instead of
+ * waiting a fixed time and hoping.  Going from standby to LoRa sleep takes
+ * two goes because LongRangeMode is only accepted once the module is asleep.
+ * @param regValue
+ * @return 1 once it reads back, 0 after LORA_MODE_TRIES
+ */
+uint8_t LoRaSetModeVerified(uint8_t regValue){
+    for(uint8_t i=0;i<LORA_MODE_TRIES;i++){
+        SPI2WriteByte(OP_MODE_REG, regValue);
+        if(SPI2ReadByte(OP_MODE_REG) == regValue){
+            return 1;
+        }
+        LORA_DELAY_US(LORA_T_POLL_US);
+    }
+    shadowValid &= ~1; //Don't know what it's in
+    return 0;
+}
+
+static int8_t shadowSlot(uint8_t reg){
+    for(uint8_t i=0;i<SHADOW_SLOTS;i++){
+        if(shadowRegs[i] == reg){
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Records a value written to the module in the shadow.
+ * Mirrors the module's rule that LongRangeMode only changes in sleep.
+ */
+static void shadowStore(uint8_t reg, uint8_t value){
+    int8_t slot = shadowSlot(reg);
+    if(slot < 0){
+        return;
+    }
+    if(reg == OP_MODE_REG && (shadowValid & 1)){
+        if((shadowValues[0] & 0b00000111) != SLEEP_MODE){
+            value = (value & ~LORA_MODE) | (shadowValues[0] & LORA_MODE);
+        }
+    }
+    else if(reg == OP_MODE_REG){
+        return; //Can't tell whether the LoRa bit was accepted
+    }
+    shadowValues[slot] = value;
+    shadowValid |= (uint16_t)1<<slot;
+}
+
+/**
+ * Reads a register, from the shadow if it holds a known value.
+ * @param reg
+ * @return register value
+ */
+uint8_t LoRaReadRegister(uint8_t reg){
+    int8_t slot = shadowSlot(reg);
+    if(slot >= 0 && (shadowValid & ((uint16_t)1<<slot))){
+        return shadowValues[slot];
+    }
+    uint8_t value = SPI2ReadByte(reg);
+    if(slot >= 0){
+        shadowValues[slot] = value;
+        shadowValid |= (uint16_t)1<<slot;
+    }
+    return value;
+}
+
+/**
+ * Writes a register, skipping the SPI transaction if the shadow shows it
+ * already holds value.
+ * @param reg
+ * @param value
+ */
+void LoRaWriteRegister(uint8_t reg, uint8_t value){
+    int8_t slot = shadowSlot(reg);
+    if(slot >= 0 && (shadowValid & ((uint16_t)1<<slot)) && shadowValues[slot] == value){
+        return;
+    }
+    SPI2WriteByte(reg, value);
+}
+
+/**
+ * Burst reads a block of registers, loading any shadowed ones on the way.
+ */
+static void shadowReadBurst(uint8_t first, uint8_t* buffer, uint8_t length){
+    SPI2ReadBurst(first, buffer, length);
+    for(uint8_t i=0;i<length;i++){
+        int8_t slot = shadowSlot(first+i);
+        if(slot >= 0){
+            shadowValues[slot] = buffer[i];
+            shadowValid |= (uint16_t)1<<slot;
+        }
+    }
+}
+
+/**
+ * Reloads every shadowed register from the module in three bursts.
+ */
+void LoRaShadowResync(){
+    uint8_t buffer[10];
+    shadowReadBurst(OP_MODE_REG, buffer, 9); //Op mode to PA config
+    shadowReadBurst(MODEM_CONFIG_1_REG, buffer, 10); //Modem config 1 to 3
+    shadowReadBurst(DIO_MAPPING_1_REG, buffer, 1);
+}
+
+//PA_CONFIG_REG value for dBm on PA_BOOST, clamped to 2 to 17
+static uint8_t paConfig(uint8_t dBm){
+    if(dBm < 2){
+        dBm = 2;
+    }
+    if(dBm > 17){
+        dBm = 17;
+    }
+    return 0x80 | (dBm - 2);
+}
+
+/**
+ * Picks up a module that was configured before the PIC reset (watchdog,
+ * MCLR...) without resetting and reloading it.  The module keeps its
+ * registers as long as it keeps power, so three burst reads that would
+ * show a reset or power loss are enough: version, LoRa mode, frequency,
+ * modem config, power and sync word.  The shadow is loaded on the way.
+ * The spreading factor and power are checked against what the caller last
+ * applied (settings.h), which a downlink may have moved off the profile.
+ * @param frf frequency register value the module should have
+ * @param syncWord
+ * @param sf spreading factor the module should have
+ * @param dBm output power the module should have
+ * @return 1 if the module is ready, 0 if it needs LoRaReset and LoRaStart
+ */
+uint8_t LoRaWarmStart(uint32_t frf, uint8_t syncWord, uint8_t sf, uint8_t dBm){
+    uint8_t buffer[10];
+    LoRaHALInit();
+    shadowValid = 0;
+    shadowReadBurst(SYNC_VALUE_REG, buffer, 10); //Sync word to version, and DIO mapping 1
+    if(buffer[VERSION_REG-SYNC_VALUE_REG] != LORA_VERSION || buffer[0] != syncWord){
+        return 0;
+    }
+    shadowReadBurst(OP_MODE_REG, buffer, 9);
+    shadowReadBurst(MODEM_CONFIG_1_REG, buffer, 10);
+    if(!(LoRaReadRegister(OP_MODE_REG) & LORA_MODE) || LoRaGetFRF() != frf){
+        return 0;
+    }
+    if(LoRaReadRegister(MODEM_CONFIG_1_REG) != LORA_MODEM_CONFIG_1 ||
+       (LoRaReadRegister(MODEM_CONFIG_2_REG) & 0xF4) != ((uint8_t)(sf<<4) | (LORA_CRC_ON<<2)) ||
+       LoRaReadRegister(PA_CONFIG_REG) != paConfig(dBm)){
+        return 0;
+    }
+    LOG_DEBUG(("LoRa warm start\r\n"));
+    return 1;
+}
+
+/**
+ * Checks the shadow against the module.
+ * The op mode is skipped while it shows TX, RX single or CAD because the
+ * module leaves those by itself.
+ * @return 1 if every known register matches, 0 otherwise
+ */
+uint8_t LoRaShadowVerify(){
+    for(uint8_t i=0;i<SHADOW_SLOTS;i++){
+        if(!(shadowValid & ((uint16_t)1<<i))){
+            continue;
+        }
+        if(i == 0){
+            uint8_t mode = shadowValues[0] & 0b00000111;
+            if(mode == TX_MODE || mode == RX_SINGLE_MODE || mode == CAD_MODE){
+                continue;
+            }
+        }
+        if(SPI2ReadByte(shadowRegs[i]) != shadowValues[i]){
+            return 0;
+        }
+    }
+    return 1;
+}
+
+
+
+void LoRaMode_RXActive(){
+    SPI2WriteByte(OP_MODE_REG, 0b1000101); //LoRa Mode with Receiver active all the time
+}
+
+/**
+ * SPI2WriteByte
+ * Writes an address byte, then writes a data byte
+ * @param address
+ * @param data
+ */
+void SPI2WriteByte(uint8_t address, uint8_t data){
+    LoRaHALSelect(); //Set SS low
+    LORA_DELAY_US(5);
+    address = address|0x80; //bit 7 set to indicate a register write
+    LoRaHALTransfer(address); //Write address
+    LORA_DELAY_US(5);
+    LoRaHALTransfer(data); //A byte is received but this is not used.
+    LORA_DELAY_US(5);
+    LoRaHALDeselect(); //Set SS high
+    shadowStore(address & 0x7F, data);
+}
+
+/**
+ * SPI2ReadByte
+ * Writes an address byte then reads a byte back.  0 is sent as a dummy value
+ * for the second transfer.
+ * @param address
+ * @return 
+ */
+uint8_t SPI2ReadByte(uint8_t address){
+    LoRaHALSelect(); //Set SS low
+    LoRaHALTransfer(address); //Write address
+    uint8_t dataByte = LoRaHALTransfer(0); //Data byte - for a read, send 0
+    LoRaHALDeselect(); //Set SS high
+    return dataByte;
+}
+
+/**
+ * SPI2WriteBurst
+ * Writes an address byte then length data bytes in one transaction.
+ * The SX1276 auto-increments the register address after each byte, or for
+ * the FIFO advances the FIFO pointer, so this replaces length calls to
+ * SPI2WriteByte with one SS assertion and one address byte.
+ * @param address first register
+ * @param data
+ * @param length
+ */
+void SPI2WriteBurst(uint8_t address, const uint8_t* data, uint8_t length){
+    LoRaHALSelect(); //Set SS low
+    LoRaHALTransfer(address|0x80); //bit 7 set to indicate a register write
+    for(uint8_t i=0;i<length;i++){
+        LoRaHALTransfer(data[i]);
+    }
+    LoRaHALDeselect(); //Set SS high
+    if(address != FIFO_REG){
+        for(uint8_t i=0;i<length;i++){
+            shadowStore(address+i, data[i]);
+        }
+    }
+}
+
+/**
+ * SPI2ReadBurst
+ * Writes an address byte then reads length bytes back in one transaction.
+ * @param address first register
+ * @param data buffer for the bytes read
+ * @param length
+ */
+void SPI2ReadBurst(uint8_t address, uint8_t* data, uint8_t length){
+    LoRaHALSelect(); //Set SS low
+    LoRaHALTransfer(address); //Write address
+    for(uint8_t i=0;i<length;i++){
+        data[i] = LoRaHALTransfer(0); //0 sent as a dummy value
+    }
+    LoRaHALDeselect(); //Set SS high
+}
+
+/* 
+ * Transmits a data packet.
+ */
+void LoRaTXData(uint8_t* data, uint8_t dataLength){
+    //Must be in standby mode for this to work
+    LoRaStandbyMode();
+    TRACE(TRACE_TX_START, dataLength);
+    SPI2WriteByte(FIFO_ADD_PTR_REG, 0);
+    SPI2WriteBurst(FIFO_REG, data, dataLength); //Whole payload in one transaction
+    LoRaWriteRegister(PAYLOAD_LENGTH_REG, dataLength); //Often the same as last time
+    LoRaTXMode(); //Set TX mode to send the message
+    
+    //Will return to standby mode automatically when finished.
+    //You can check TxDone interrupt to see if it's finished.
+}
+
+/**
+ * Starts transmitting a packet with TxDone mapped to DIO0, so the PIC can
+ * sleep until it's sent.  Follow with LoRaTXWait.
+ * @param data
+ * @param dataLength
+ */
+void LoRaTXStart(uint8_t* data, uint8_t dataLength){
+    uint8_t mapping = LoRaReadRegister(DIO_MAPPING_1_REG);
+    LoRaWriteRegister(DIO_MAPPING_1_REG, (mapping & ~DIO0_MASK) | DIO0_TX_DONE);
+    LoRaClearIRQFlags(); //DIO0 follows the flag so it must start low
+    LoRaTXData(data, dataLength);
+}
+
+/**
+ * Sleeps the PIC until DIO0 signals TxDone, then clears the IRQ flags and
+ * puts the radio to sleep.  Every SLEEP ends on DIO0 or a watchdog wake
+ * (2s), so the wait gives up after timeoutWakes watchdog periods.
+ * @param timeoutWakes
+ * @return 1 if the packet was sent, 0 if it timed out
+ */
+uint8_t LoRaTXWait(uint8_t timeoutWakes){
+    uint8_t wakes = 0;
+    while(!LoRaHALDIO0() && wakes < timeoutWakes){
+        LoRaHALSleep();
+        wakes++;
+    }
+    uint8_t flags = LoRaGetIRQFlags();
+    uint8_t sent = (flags & IRQ_TX_DONE) != 0;
+    if(sent){
+        TRACE(TRACE_TX_DONE, wakes);
+    }
+    else{
+        TRACE(TRACE_TX_TIMEOUT, flags);
+        LOG_ERROR(("TX timeout, IRQ flags %X\r\n", flags));
+    }
+    LoRaClearIRQFlags();
+    LoRaSleepMode(); //Also abandons the packet if it timed out
+    return sent;
+}
+
+/**
+ * Transmits a packet with the PIC asleep for the time on air.
+ * @param data
+ * @param dataLength
+ * @param timeoutWakes watchdog periods to wait for TxDone
+ * @return 1 if the packet was sent, 0 if it timed out
+ */
+uint8_t LoRaTXDataSleep(uint8_t* data, uint8_t dataLength, uint8_t timeoutWakes){
+    LoRaTXStart(data, dataLength);
+    return LoRaTXWait(timeoutWakes);
+}
+
+/**
+ * Sets the LoRa module into standby mode
+ */
+void LoRaStandbyMode(){
+    uint8_t regValue = readOpModeRegister(); //Read whats in there already
+    uint8_t asleep = (regValue & 0b00000111) == SLEEP_MODE;
+    regValue = regValue & 0b11111000; //Blank out other modes
+    regValue = regValue | STANDBY_MODE; //Set bit 0 high and leave others as is
+    writeOpModeRegister(regValue); //Write the value back
+    if(asleep){
+        LORA_DELAY_US(LORA_T_OSC_US); //No ModeReady flag in LoRa mode, wait for the crystal before the FIFO is used
+    }
+}
+
+void LoRaSleepMode(){
+    uint8_t regValue = readOpModeRegister(); //Read whats in there already
+    regValue = regValue & 0b11111000; //Blank out other modes
+    regValue = regValue | SLEEP_MODE;
+    writeOpModeRegister(regValue); //Write the value back
+}
+
+void LoRaFreqSynthRXMode(){
+    uint8_t regValue = readOpModeRegister(); //Read whats in there already
+    regValue = regValue & 0b11111000; //Blank out other modes
+    regValue = regValue | FREQ_SYNTH_RX_MODE; //Set bit 0 high and leave others as is
+    writeOpModeRegister(regValue); //Write the value back
+}
+
+void LoRaFreqSynthTXMode(){
+    uint8_t regValue = readOpModeRegister(); //Read whats in there already
+    regValue = regValue & 0b11111000; //Blank out other modes
+    regValue = regValue | FREQ_SYNTH_TX_MODE; //Set bit 0 high and leave others as is
+    writeOpModeRegister(regValue); //Write the value back
+}
+
+void LoRaTXMode(){
+    uint8_t regValue = readOpModeRegister(); //Read whats in there already
+    regValue = regValue & 0b11111000; //Blank out other modes
+    regValue = regValue | TX_MODE; //Set bit 0 high and leave others as is
+    writeOpModeRegister(regValue); //Write the value back
+}
+
+void LoRaCADMode(){
+    uint8_t regValue = readOpModeRegister(); //Read whats in there already
+    regValue = regValue & 0b11111000; //Blank out other modes
+    regValue = regValue | CAD_MODE;
+    writeOpModeRegister(regValue); //Write the value back
+}
+
+/**
+ * Channel activity detection: listens for a LoRa preamble with the PIC
+ * asleep until CadDone on DIO0.  Takes about two symbols, 2ms at
+ * SF7/125kHz.  The module is left in standby, ready for LoRaTXStart.
+ * @return 1 if the channel is busy or CAD didn't finish
+ */
+uint8_t LoRaCAD(){
+    uint8_t mapping = LoRaReadRegister(DIO_MAPPING_1_REG);
+    LoRaWriteRegister(DIO_MAPPING_1_REG, (mapping & ~DIO0_MASK) | DIO0_CAD_DONE);
+    LoRaStandbyMode();
+    LoRaClearIRQFlags(); //DIO0 follows the flag so it must start low
+    LoRaCADMode();
+    if(!LoRaHALDIO0()){
+        LoRaHALSleep(); //CadDone, or the watchdog if it never comes
+    }
+    uint8_t flags = LoRaGetIRQFlags();
+    LoRaClearIRQFlags();
+    TRACE(TRACE_CAD, flags);
+    if(!(flags & IRQ_CAD_DONE)){
+        LoRaStandbyMode();
+        return 1;
+    }
+    return (flags & IRQ_CAD_DETECTED) != 0;
+}
+
+void LoRaRXSingleMode(){
+    uint8_t regValue = readOpModeRegister(); //Read whats in there already
+    regValue = regValue & 0b11111000; //Blank out other modes
+    regValue = regValue | RX_SINGLE_MODE;
+    writeOpModeRegister(regValue); //Write the value back
+}
+
+/**
+ * Listens for one packet in RX single mode.  The module gives up by itself
+ * (RxTimeout) if no preamble turns up within the symbol timeout.  RxTimeout
+ * isn't wired to the PIC, so the IRQ flags are polled until then; once a
+ * valid header has come in the PIC sleeps until RxDone on DIO0.
+ * Keep the symbol timeout plus the preamble well inside the 2s watchdog,
+ * which isn't cleared while polling.
+ * Ends with the module asleep.
+ * @param data buffer for the payload
+ * @param maxLength buffer size, longer packets are dropped
+ * @param symbols symbol timeout, 4 to 1023
+ * @return payload length, 0 if nothing good was received
+ */
+uint8_t LoRaRXSingle(uint8_t* data, uint8_t maxLength, uint16_t symbols){
+    uint8_t mapping = LoRaReadRegister(DIO_MAPPING_1_REG);
+    LoRaWriteRegister(DIO_MAPPING_1_REG, (mapping & ~DIO0_MASK) | DIO0_RX_DONE);
+    LoRaWriteRegister(MODEM_CONFIG_2_REG, (LoRaReadRegister(MODEM_CONFIG_2_REG) & 0xFC) | ((symbols>>8) & 0x03));
+    SPI2WriteByte(SYMB_TIMEOUT_LSB_REG, symbols & 0xFF);
+    SPI2WriteByte(FIFO_RX_BASE_ADDR_REG, 0);
+    LoRaStandbyMode();
+    LoRaClearIRQFlags(); //DIO0 follows the flag so it must start low
+    LoRaRXSingleMode();
+    uint8_t preamble[2];
+    SPI2ReadBurst(PREAMBLE_MSB_REG, preamble, 2);
+    //A preamble found at the end of the timeout still needs its own length and the header
+    uint32_t wait = (uint32_t)symbols + ((uint16_t)preamble[0]<<8 | preamble[1]) + LORA_RX_HEADER_SYMBOLS;
+    uint32_t polls = wait*LoRaSymbolUs()/LORA_T_RX_POLL_US + LORA_RX_POLL_SPARE;
+    uint8_t flags = 0;
+    while(polls--){
+        flags = LoRaGetIRQFlags();
+        if(flags & (IRQ_RX_DONE | IRQ_RX_TIMEOUT)){
+            break;
+        }
+        if(flags & IRQ_VALID_HEADER){
+            LoRaHALSleep(); //RxDone, or the watchdog for a long packet
+        }
+        else{
+            LORA_DELAY_US(LORA_T_RX_POLL_US);
+        }
+    }
+    uint8_t length = 0;
+    if((flags & IRQ_RX_DONE) && !(flags & IRQ_CRC_ERROR)){
+        length = SPI2ReadByte(RX_NB_BYTES_REG);
+        if(length > maxLength){
+            length = 0;
+        }
+        else{
+            SPI2WriteByte(FIFO_ADD_PTR_REG, SPI2ReadByte(FIFO_RX_CURRENT_REG));
+            SPI2ReadBurst(FIFO_REG, data, length);
+        }
+    }
+    TRACE(TRACE_RX, flags);
+    LoRaClearIRQFlags();
+    LoRaSleepMode(); //Also ends a window that ran past the poll limit
+    return length;
+}
+
+void LoRaRXContinuousMode(){
+    uint8_t regValue = readOpModeRegister(); //Read whats in there already
+    regValue = regValue & 0b11111000; //Blank out other modes
+    regValue = regValue | RX_CONT_MODE; //Set bit 0 high and leave others as is
+    writeOpModeRegister(regValue); //Write the value back02
+}
+
+/**
+ * Sets the frequency register of the LoRa module
+ * @param frf 24 bit register value, LORA_FRF(Hz) works it out at build time
+ */
+void LoRaSetFRF(uint32_t frf){
+    uint8_t msb = (frf>>16) & 0xFF; //Extract MSB
+    uint8_t mid = (frf>>8)& 0xFF; //Extract mid byte
+    uint8_t lsb = frf & 0xFF; //Extract LSB
+    LoRaWriteRegister(FRF_MSB_REG,msb);
+    LoRaWriteRegister(FRF_MID_REG,mid);
+    LoRaWriteRegister(FRF_LSB_REG,lsb);
+}
+
+/**
+ * Gets the frequency register from the device.
+ * @return 24 bit register value
+ */
+uint32_t LoRaGetFRF(){
+    uint8_t msb = LoRaReadRegister(FRF_MSB_REG);
+    uint8_t mid = LoRaReadRegister(FRF_MID_REG);
+    uint8_t lsb = LoRaReadRegister(FRF_LSB_REG);
+    return (uint32_t)msb<<16 | (uint32_t)mid<<8 | lsb;
+}
+
+/**
+ * Sets the frequency of the LoRa module
+ * @param  Frequency in Hz
+ * 
+ * Frf = XOSC * FreqReg/2^19
+ * Resolution is 61.035Hz for XOSC=32MHz.
+ * Integer only, see LORA_FRF.
+ */
+void LoRaSetFrequency(uint32_t hz){
+    LoRaSetFRF(LORA_FRF(hz));
+}
+
+/**
+ * Gets the centre frequency from the device.
+ * @return Frequency in Hz, to the nearest Hz.
+ */
+uint32_t LoRaGetFrequency(){
+    uint32_t frf = LoRaGetFRF();
+    //Hz = Frf * 15625/256, split so it fits in 32 bits
+    return (frf>>8)*15625UL + (((frf & 0xFF)*15625UL + 128)>>8);
+}
+
+/**
+ * Symbol time for the modem settings.  The bandwidths are 500kHz divided
+ * by 64, 48, 32, 24, 16, 12, 8, 4, 2 and 1, so a symbol is
+ * 2^SF x divider x 2us exactly.
+ * @param config1 MODEM_CONFIG_1_REG value, bandwidth in bits 7-4
+ * @param config2 MODEM_CONFIG_2_REG value, spreading factor in bits 7-4
+ * @return microseconds
+ */
+static uint32_t symbolUs(uint8_t config1, uint8_t config2){
+    static const uint8_t bwDivider[10] = {64, 48, 32, 24, 16, 12, 8, 4, 2, 1};
+    uint8_t bw = config1>>4;
+    uint8_t sf = config2>>4;
+    if(bw > 9){
+        bw = 9; //Reserved values
+    }
+    if(sf < 6){
+        sf = 6;
+    }
+    return ((uint32_t)bwDivider[bw]<<sf)<<1;
+}
+
+/**
+ * Time on air for a packet with the given modem settings (Semtech
+ * formula, SX1276 datasheet 4.1.1.7), integer only.
+ * @param config1 MODEM_CONFIG_1_REG value: bandwidth, coding rate, implicit header
+ * @param config2 MODEM_CONFIG_2_REG value: spreading factor, CRC
+ * @param config3 MODEM_CONFIG_3_REG value: low data rate optimisation
+ * @param preamble symbols as programmed, the module adds 4.25
+ * @param length payload bytes
+ * @return microseconds, 0xFFFFFFFF if it doesn't fit
+ */
+uint32_t LoRaAirTimeUs(uint8_t config1, uint8_t config2, uint8_t config3, uint16_t preamble, uint8_t length){
+    uint8_t cr = (config1>>1) & 0x07;
+    uint8_t implicitHeader = config1 & 0x01;
+    uint8_t sf = config2>>4;
+    uint8_t crc = (config2>>2) & 0x01;
+    uint8_t ldro = (config3>>3) & 0x01;
+    if(sf < 6){
+        sf = 6;
+    }
+    uint32_t quarterSymbolUs = symbolUs(config1, config2)>>2; //At least 32
+    //Payload symbols: 8 + max(ceil((8PL - 4SF + 28 + 16CRC - 20IH) / 4(SF - 2DE)) x (CR + 4), 0)
+    int16_t bits = 8*(int16_t)length - 4*sf + 28 + 16*crc - 20*implicitHeader;
+    uint16_t symbols = 8;
+    if(bits > 0){
+        uint8_t perBlock = 4*(sf - 2*ldro);
+        symbols += (bits + perBlock - 1)/perBlock * (cr + 4);
+    }
+    //In quarter symbols, so the 4.25 preamble symbols stay exact
+    uint32_t quarters = 4UL*preamble + 17 + 4UL*symbols;
+    if(quarters > 0xFFFFFFFFUL/quarterSymbolUs){
+        return 0xFFFFFFFFUL;
+    }
+    return quarters*quarterSymbolUs;
+}
+
+/**
+ * Time on air for a payload with the settings in the module now.  Modem
+ * config comes from the register shadow, so this costs one SPI transaction
+ * for the preamble length.
+ * @param length payload bytes
+ * @return microseconds
+ */
+uint32_t LoRaTimeOnAir(uint8_t length){
+    uint8_t preamble[2];
+    SPI2ReadBurst(PREAMBLE_MSB_REG, preamble, 2);
+    return LoRaAirTimeUs(LoRaReadRegister(MODEM_CONFIG_1_REG), LoRaReadRegister(MODEM_CONFIG_2_REG),
+            LoRaReadRegister(MODEM_CONFIG_3_REG), (uint16_t)preamble[0]<<8 | preamble[1], length);
+}
+
+/**
+ * Symbol time with the settings in the module now, from the register shadow.
+ * @return microseconds
+ */
+uint32_t LoRaSymbolUs(){
+    return symbolUs(LoRaReadRegister(MODEM_CONFIG_1_REG), LoRaReadRegister(MODEM_CONFIG_2_REG));
+}
+
+/**
+ * Changes the spreading factor and turns low data rate optimisation on or
+ * off to suit (mandatory above 16ms a symbol).  The rest of the modem
+ * settings are kept.  Can be called in sleep.
+ * @param sf 7 to 12 (SF6 needs an implicit header)
+ */
+void LoRaSetSpreadingFactor(uint8_t sf){
+    LoRaWriteRegister(MODEM_CONFIG_2_REG, (LoRaReadRegister(MODEM_CONFIG_2_REG) & 0x0F) | (uint8_t)(sf<<4));
+    uint8_t config3 = LoRaReadRegister(MODEM_CONFIG_3_REG) & ~0x08;
+    if(LoRaSymbolUs() > 16000){
+        config3 |= 0x08;
+    }
+    LoRaWriteRegister(MODEM_CONFIG_3_REG, config3);
+}
+
+/**
+ * Sets the output power on the PA_BOOST pin (the only PA the RFM95W
+ * brings out).  Can be called in sleep.
+ * @param dBm 2 to 17, clamped
+ */
+void LoRaSetPower(uint8_t dBm){
+    LoRaWriteRegister(PA_CONFIG_REG, paConfig(dBm));
+}
+
+uint8_t LoRaGetIRQFlags(){
+    uint8_t regValue = SPI2ReadByte(IRQ_FLAGS_REG);
+    return regValue;
+}
+
+void LoRaClearIRQFlags(){
+    SPI2WriteByte(IRQ_FLAGS_REG,0xFF);
+}
+
+
+/**
+ * Dumps the contents of all registers to printf
+ * Only does anything in a LOG_LEVEL_DEBUG build.
+ */
+void LoRaDumpRegisters(){
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    for(uint8_t reg=0x0;reg<0x20;reg++){
+        LOG_DEBUG(("Reg %X:%X\r\n", reg, SPI2ReadByte(reg)));
+    }
+#endif
+}
+
+/*
+ * Register load for LoRaOptimalLoad, streamed with one burst per range.
+ * Each range is: first register, number of registers, values.
+ * A range with 0 registers ends the table.
+ * Gaps at 0x0D (FIFO pointer), 0x12 (IRQ flags, write 1 to clear) and 0x22
+ * (payload length, set by LoRaTXData) are written with harmless values so
+ * that neighbouring ranges join up.
+ */
+const uint8_t LoRaOptimalProfile[] = {
+    FRF_MSB_REG, 14,
+        LORA_FRF_MSB(LORA_FREQ_HZ), LORA_FRF_MID(LORA_FREQ_HZ), LORA_FRF_LSB(LORA_FREQ_HZ),
+        LORA_PA_CONFIG, 0x09, 0x2B, 0x23, //PA config, PA ramp, OCP, LNA
+        0, 0, 0, 0, 0, 0, 0, //FIFO pointer and base addresses, IRQ mask and flags, RX bytes
+    MODEM_CONFIG_1_REG, 10,
+        LORA_MODEM_CONFIG_1, LORA_MODEM_CONFIG_2,
+        0x64, LORA_PREAMBLE_MSB, LORA_PREAMBLE_LSB, //Symbol timeout, preamble
+        0x01, 0xFF, 0, 0, //Payload length, max payload, hop period, RX byte address
+        LORA_MODEM_CONFIG_3,
+    0x2F, 3, 0x45, 0x55, 0xC3,
+    0x33, 1, 0x27,
+    0x36, 2, 0x03, 0x0A,
+    TXCO_REG, 1, 0x09,
+    PA_DAC_REG, 1, 0x84,
+    AGC_REF_REG, 4, 0x1C, 0x0E, 0x5B, 0xCC,
+    0x70, 1, 0xD0,
+    0, 0
+};
+
+/**
+ * Streams a register table (see LoRaOptimalProfile) to the module.
+ * The module must be in sleep or standby.
+ * @param table
+ */
+void LoRaLoadProfile(const uint8_t* table){
+    while(table[1] != 0){
+        SPI2WriteBurst(table[0], &table[2], table[1]);
+        table += table[1] + 2;
+    }
+}
+
+/**
+ * Loads all the registers required to setup an optimal configuration
+ */
+void LoRaOptimalLoad(uint8_t syncWord){
+    //Can only change to LoRa mode in sleep mode
+    uint8_t regValue = (readOpModeRegister() & 0b01111000) | LORA_MODE | SLEEP_MODE;
+    if(!LoRaSetModeVerified(regValue)){
+        LOG_ERROR(("LoRa mode not accepted\r\n"));
+    }
+    //Everything except the FIFO can be written in sleep, so there's no need
+    //to wait for the oscillator to start first
+    LoRaLoadProfile(LoRaOptimalProfile);
+    uint8_t sync[2];
+    sync[0] = syncWord; //Sync word was 0x12
+    sync[1] = 0x49; //Register 0x3A follows it
+    SPI2WriteBurst(SYNC_VALUE_REG, sync, 2);
+    LoRaStandbyMode();
+}
@@ -1,123 +1,202 @@
-/* 
- * File:   lora.h
- * Author: Andy Page
- * Comments: LoRa library for RFM95W module used with PIC18F46K22 on SPI2 port
- * Revision history: Version 1, 19th March 2021
- * Simplified version for small memory footprint.
- * The bare essentials for transmitting data.
- */
-
-// This is a guard condition so that contents of this file are not included
-// more than once.  
-#ifndef LORA_H
-#define	LORA_H
-
-#include <stdint.h>
-#include "defines.h"
-
-//NB ONLY LoRa REGISTERS ARE DEFINED - FSK/OOK MODE REGISTERS ARE NOT!
-#define FIFO_REG 0x00
-#define OP_MODE_REG 0x01
-#define FRF_MSB_REG 0x06
-#define FRF_MID_REG 0x07
-#define FRF_LSB_REG 0x08
-#define PA_CONFIG_REG 0x09
-#define PA_RAMP_REG 0x0A
-#define OCP_REG 0x0B
-#define LNA_REG 0x0C
-#define FIFO_ADD_PTR_REG 0x0D
-#define FIFO_TX_BASE_ADDR_REG 0x0E
-#define FIFO_RX_BASE_ADDR_REG 0x0F
-#define FIFO_RX_CURRENT_REG 0x10
-#define IRQ_FLAGS_MASK_REG 0x11
-#define IRQ_FLAGS_REG 0x12
-#define RX_NB_BYTES_REG 0x13
-#define RX_HEADER_CNT_VALUE_MSB_REG 0x14
-#define RX_HEADER_CNT_VALUE_LSB_REG 0x15
-#define RX_PACKET_CNT_VALUE_MSB_REG 0x16
-#define RX_PACKET_CNT_VALUE_LSB_REG 0x17
-#define MODEM_STAT_REG 0x18
-#define PKT_SNR_VALUE_REG 0x19
-#define PKT_RSSI_VALUE_REG 0x1A
-#define RSSI_VALUE_REG 0x1B
-#define HOP_CHANNEL_REG 0x1C
-#define MODEM_CONFIG_1_REG 0x1D
-#define MODEM_CONFIG_2_REG 0x1E
-#define SYMB_TIMEOUT_LSB_REG 0x1F
-#define PREAMBLE_MSB_REG 0x20
-#define PREAMBLE_LSB_REG 0x21
-#define PAYLOAD_LENGTH_REG 0x22
-#define MAX_PAYLOAD_LENGTH_REG 0x23
-#define HOP_PERIOD_REG 0x24
-#define FIFO_RX_BYTE_ADDR_REG 0x25
-#define MODEM_CONFIG_3_REG 0x26
-#define SYNC_VALUE_REG 0x39
-//0x27 to 0x3F RESERVED in LoRa mode (0x3C, 0x3D???)
-#define TEMP_REG 0x3C
-#define LOW_BAT_REG 0x3D
-#define DIO_MAPPING_1_REG 0x40
-#define DIO_MAPPING_2_REG 0x41
-#define VERSION_REG 0x42
-//0x43, 0x44 UNUSED
-#define TXCO_REG 0x4B
-#define PA_DAC_REG 0x4D
-
-#define FORMER_TEMP_REG 0x5B
-
-#define AGC_REF_REG 0x61
-#define AGC_THRESH_1_REG 0x62
-#define AGC_THRESH_2_REG 0x63
-#define AGC_THRESH_3_REG 0x64
-
-
-//Operating modes
-#define STANDBY_MODE 0b00000001
-#define SLEEP_MODE 0b00000000
-#define FREQ_SYNTH_TX_MODE 0b00000010
-#define TX_MODE 0b00000011
-#define FREQ_SYNTH_RX_MODE 0b00000100
-#define RX_CONT_MODE 0b00000101
-#define RX_SINGLE_MODE 0b00000110
-#define CAD_MODE 0b00000111
-#define LORA_MODE 0b10000000
-
-//Bandwidths to use with set and get bandwidth
-#define BW7k8 0b0000
-#define BW10k4 0b0001
-#define BW15k6 0b0010
-#define BW20k8 0b0011
-#define BW31k25 0b0100
-#define BW41k7 0b0101
-#define BW62k5 0b0110
-#define BW125k 0b0111
-#define BW250k 0b1000
-#define BW500k 0b1001
-
-
-
-void LoRaStart(float, uint8_t);
-uint8_t LoRaGetVersion();
-void LoRaReset();
-void setLoRaMode(); //Sets module into LoRa mode
-uint8_t readOpModeRegister();
-void writeOpModeRegister(uint8_t);
-void LoRaSleepMode(); //Set sleep mode
-void LoRaStandbyMode(); //Set standby mode
-void LoRaFreqSynthRXMode();
-void LoRaFreqSynthTXMode();
-void LoRaTXMode();
-void LoRaRXContinuousMode();
-void LoRaMode_RXActive(); //Set LoRa mode with receiver always active
-void LoRaTXData(uint8_t* , uint8_t); //Sends a data packet of length dataLength
-void SPI2WriteByte(uint8_t, uint8_t);
-uint8_t SPI2ReadByte(uint8_t);
-void LoRaSetFrequency(float);
-float LoRaGetFrequency(void);
-uint8_t LoRaGetIRQFlags();
-void LoRaClearIRQFlags();
-
-void LoRaDumpRegisters();
-void LoRaOptimalLoad(uint8_t); //Provides an optimal register load to get working quickly.
-
-
-#endif	/* CONFIG_H */
+/* 
+ * File:   lora.h
+ * Author: Andy Page
+ * Comments: LoRa library for RFM95W module used with PIC18F46K22 on SPI2 port
+ * Revision history: Version 1, 19th March 2021
+ * Simplified version for small memory footprint.
+ * The bare essentials for transmitting data.
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.  
+#ifndef LORA_H
+#define	LORA_H
+
+#include <stdint.h>
+#include "defines.h"
+
+//NB ONLY LoRa REGISTERS ARE DEFINED - FSK/OOK MODE REGISTERS ARE NOT!
+#define FIFO_REG 0x00
+#define OP_MODE_REG 0x01
+#define FRF_MSB_REG 0x06
+#define FRF_MID_REG 0x07
+#define FRF_LSB_REG 0x08
+#define PA_CONFIG_REG 0x09
+#define PA_RAMP_REG 0x0A
+#define OCP_REG 0x0B
+#define LNA_REG 0x0C
+#define FIFO_ADD_PTR_REG 0x0D
+#define FIFO_TX_BASE_ADDR_REG 0x0E
+#define FIFO_RX_BASE_ADDR_REG 0x0F
+#define FIFO_RX_CURRENT_REG 0x10
+#define IRQ_FLAGS_MASK_REG 0x11
+#define IRQ_FLAGS_REG 0x12
+#define RX_NB_BYTES_REG 0x13
+#define RX_HEADER_CNT_VALUE_MSB_REG 0x14
+#define RX_HEADER_CNT_VALUE_LSB_REG 0x15
+#define RX_PACKET_CNT_VALUE_MSB_REG 0x16
+#define RX_PACKET_CNT_VALUE_LSB_REG 0x17
+#define MODEM_STAT_REG 0x18
+#define PKT_SNR_VALUE_REG 0x19
+#define PKT_RSSI_VALUE_REG 0x1A
+#define RSSI_VALUE_REG 0x1B
+#define HOP_CHANNEL_REG 0x1C
+#define MODEM_CONFIG_1_REG 0x1D
+#define MODEM_CONFIG_2_REG 0x1E
+#define SYMB_TIMEOUT_LSB_REG 0x1F
+#define PREAMBLE_MSB_REG 0x20
+#define PREAMBLE_LSB_REG 0x21
+#define PAYLOAD_LENGTH_REG 0x22
+#define MAX_PAYLOAD_LENGTH_REG 0x23
+#define HOP_PERIOD_REG 0x24
+#define FIFO_RX_BYTE_ADDR_REG 0x25
+#define MODEM_CONFIG_3_REG 0x26
+#define SYNC_VALUE_REG 0x39
+//0x27 to 0x3F RESERVED in LoRa mode (0x3C, 0x3D???)
+#define TEMP_REG 0x3C
+#define LOW_BAT_REG 0x3D
+#define DIO_MAPPING_1_REG 0x40
+#define DIO_MAPPING_2_REG 0x41
+#define VERSION_REG 0x42
+//0x43, 0x44 UNUSED
+#define TXCO_REG 0x4B
+#define PA_DAC_REG 0x4D
+
+#define LORA_VERSION 0x12 //VERSION_REG value for the SX1276
+
+/*
+ * Timing.  Mode changes are confirmed by reading RegOpMode back
+ * (LoRaSetModeVerified) rather than by fixed delays.  Typical transition
+ * times from the SX1276 datasheet (section 2.5 and table 7), not measured on
+ * this board.  The host simulator uses the same figures:
+ *   Power on to ready             10ms
+ *   Reset released to ready        5ms   LORA_T_RESET_READY_US
+ *   Sleep to standby             250us   LORA_T_OSC_US, crystal start up
+ *   Standby to FSTX/FSRX          60us   PLL lock
+ *   FSTX to TX                   120us   includes PA ramp (RegPaRamp 0x09 = 40us)
+ *   TX done to standby           automatic, TxDone IRQ
+ * Only sleep to standby needs the PIC to wait: RegOpMode reads back standby
+ * straight away but the FIFO isn't usable until the crystal runs, and LoRa
+ * mode has no ModeReady flag to poll, so LoRaStandbyMode waits
+ * LORA_T_OSC_US when it finds the module asleep.  Other registers can be written in
+ * sleep, and the module sequences standby -> FSTX -> TX itself.
+ * To check them on our hardware, put TRACE() either side of a mode change in
+ * a debug build and time the DIO0/SS lines on the scope.
+ */
+#define LORA_T_RESET_PULSE_US 100 //NRESET low for at least 100us
+#define LORA_T_RESET_READY_US 5000
+#define LORA_T_OSC_US 250 //Crystal start up leaving sleep, datasheet TS_OSC
+#define LORA_T_POLL_US 50 //Between op mode read backs
+#define LORA_MODE_TRIES 10 //Read backs before giving up, about 1ms
+#define LORA_T_RX_POLL_US 1000 //Between IRQ flag reads while waiting for a preamble
+#define LORA_RX_POLL_SPARE 4 //Polls on top of the symbol timeout
+#define LORA_RX_HEADER_SYMBOLS 13 //4.25 preamble symbols the module adds, and an 8 symbol header
+
+#define FORMER_TEMP_REG 0x5B
+
+#define AGC_REF_REG 0x61
+#define AGC_THRESH_1_REG 0x62
+#define AGC_THRESH_2_REG 0x63
+#define AGC_THRESH_3_REG 0x64
+
+
+//Operating modes
+#define STANDBY_MODE 0b00000001
+#define SLEEP_MODE 0b00000000
+#define FREQ_SYNTH_TX_MODE 0b00000010
+#define TX_MODE 0b00000011
+#define FREQ_SYNTH_RX_MODE 0b00000100
+#define RX_CONT_MODE 0b00000101
+#define RX_SINGLE_MODE 0b00000110
+#define CAD_MODE 0b00000111
+#define LORA_MODE 0b10000000
+
+//IRQ flags register bits
+#define IRQ_RX_TIMEOUT 0b10000000
+#define IRQ_RX_DONE 0b01000000
+#define IRQ_CRC_ERROR 0b00100000
+#define IRQ_VALID_HEADER 0b00010000
+#define IRQ_TX_DONE 0b00001000
+#define IRQ_CAD_DONE 0b00000100
+#define IRQ_FHSS_CHANGE 0b00000010
+#define IRQ_CAD_DETECTED 0b00000001
+
+//DIO0 function in DIO_MAPPING_1_REG bits 7-6
+#define DIO0_RX_DONE 0b00000000
+#define DIO0_TX_DONE 0b01000000
+#define DIO0_CAD_DONE 0b10000000
+#define DIO0_MASK 0b11000000
+
+//Bandwidths to use with set and get bandwidth
+#define BW7k8 0b0000
+#define BW10k4 0b0001
+#define BW15k6 0b0010
+#define BW20k8 0b0011
+#define BW31k25 0b0100
+#define BW41k7 0b0101
+#define BW62k5 0b0110
+#define BW125k 0b0111
+#define BW250k 0b1000
+#define BW500k 0b1001
+
+//Frequency register value for a frequency in Hz, rounded to the nearest step.
+//Frf = Hz * 2^19/32MHz = Hz * 256/15625, split up so it never overflows
+//32 bits.  With a constant argument the compiler works it out at build time.
+#define LORA_FRF(hz) ((uint32_t)(hz)/15625UL*256UL + ((uint32_t)(hz)%15625UL*256UL + 7812UL)/15625UL)
+#define LORA_FRF_MSB(hz) ((uint8_t)(LORA_FRF(hz)>>16))
+#define LORA_FRF_MID(hz) ((uint8_t)(LORA_FRF(hz)>>8))
+#define LORA_FRF_LSB(hz) ((uint8_t)LORA_FRF(hz))
+
+
+
+void LoRaStart(uint32_t, uint8_t); //Frequency register value (LORA_FRF) and sync word
+uint8_t LoRaGetVersion();
+void LoRaReset();
+void setLoRaMode(); //Sets module into LoRa mode
+uint8_t readOpModeRegister();
+uint8_t LoRaSetModeVerified(uint8_t); //Writes the op mode until it reads back. 1 if OK
+void writeOpModeRegister(uint8_t);
+void LoRaSleepMode(); //Set sleep mode
+void LoRaStandbyMode(); //Set standby mode
+void LoRaFreqSynthRXMode();
+void LoRaFreqSynthTXMode();
+void LoRaTXMode();
+void LoRaRXContinuousMode();
+void LoRaRXSingleMode();
+uint8_t LoRaRXSingle(uint8_t*, uint8_t, uint16_t); //Buffer, its size, symbol timeout.  Received length, 0 if none.
+void LoRaCADMode();
+uint8_t LoRaCAD(void); //Channel activity detection, PIC asleep.  1 if busy
+void LoRaMode_RXActive(); //Set LoRa mode with receiver always active
+void LoRaTXData(uint8_t* , uint8_t); //Sends a data packet of length dataLength
+void LoRaTXStart(uint8_t*, uint8_t); //As LoRaTXData with TxDone signalled on DIO0
+uint8_t LoRaTXWait(uint8_t); //Sleeps the PIC until TxDone, then sleeps the radio. 1 if sent
+uint8_t LoRaTXDataSleep(uint8_t*, uint8_t, uint8_t); //LoRaTXStart then LoRaTXWait
+void SPI2WriteByte(uint8_t, uint8_t);
+uint8_t SPI2ReadByte(uint8_t);
+void SPI2WriteBurst(uint8_t, const uint8_t*, uint8_t); //Writes consecutive registers or the FIFO in one transaction
+void SPI2ReadBurst(uint8_t, uint8_t*, uint8_t); //Reads consecutive registers or the FIFO in one transaction
+void LoRaSetFRF(uint32_t); //Frequency register value
+uint32_t LoRaGetFRF(void);
+void LoRaSetFrequency(uint32_t); //Hz
+uint32_t LoRaGetFrequency(void); //Hz
+uint32_t LoRaAirTimeUs(uint8_t, uint8_t, uint8_t, uint16_t, uint8_t); //Modem config 1-3, preamble, payload length.  Microseconds.
+uint32_t LoRaTimeOnAir(uint8_t); //Microseconds for a payload length with the module's current settings
+uint32_t LoRaSymbolUs(void); //Microseconds per symbol with the module's current settings
+void LoRaSetSpreadingFactor(uint8_t); //7 to 12, sets low data rate optimisation to suit
+void LoRaSetPower(uint8_t); //dBm on PA_BOOST, 2 to 17
+uint8_t LoRaGetIRQFlags();
+void LoRaClearIRQFlags();
+
+uint8_t LoRaReadRegister(uint8_t); //Read through the register shadow
+void LoRaWriteRegister(uint8_t, uint8_t); //Write skipped if the shadow shows no change
+void LoRaShadowResync(); //Reload the register shadow from the module
+uint8_t LoRaWarmStart(uint32_t, uint8_t, uint8_t, uint8_t); //Frequency register, sync word, spreading factor, dBm.  Reuses a module configured before a PIC reset. 1 if OK
+uint8_t LoRaShadowVerify(); //1 if the register shadow matches the module
+
+void LoRaDumpRegisters();
+void LoRaOptimalLoad(uint8_t); //Provides an optimal register load to get working quickly.
+void LoRaLoadProfile(const uint8_t*); //Streams a register range table to the module
+extern const uint8_t LoRaOptimalProfile[]; //Table used by LoRaOptimalLoad, built from LoRaProfile.h
+
+
+#endif	/* CONFIG_H */
@@ -0,0 +1,157 @@
+/*
+ * File:   LoRaHAL.c
+ * PIC18F46K22 implementation of the LoRa hardware access layer.
+ * RFM95W is on SPI2 (RD0 SCK, RD1 SDI, RD4 SDO, RD3 SS) with reset on RA2
+ * and DIO0 on INT0 when it's wired (see defines.h).
+ */
+#include <xc.h>
+#include "LoRaHAL.h"
+#include "LoRa.h"
+
+#if !LORA_DIO0_WIRED
+#define DIO0_POLL_PR2 (CLOCK_FAST_HZ/4/16/(1000000UL/DIO0_POLL_US) - 1) //Timer 2 at Fosc/4 through the 1:16 prescaler
+#if DIO0_POLL_PR2 < 1 || DIO0_POLL_PR2 > 255
+#error DIO0_POLL_US must fit Timer 2
+#endif
+#endif
+
+/**
+ * Boosts the clock and configures SPI2 as master for the RFM95W
+ * from PIC18F46K22_LoRA_UVVIS_V2
+ */
+void LoRaHALInit(){
+    clockBoost(); //Before the SPI clock is set, it's a division of Fosc
+    //Configure pin for LoRa module reset
+    ANSELAbits.ANSA2=0; //Digital output buffer enabled (analogue function turned off)
+
+    //Configure SPI2 as master
+    //Set up SPI pins first
+    TRISDbits.RD1=1; //SDIx must have corresponding TRIS bit set (input)
+    TRISDbits.RD4=0; //SDOx must have corresponding TRIS bit cleared (output)
+    TRISDbits.RD0=0; //SCKx (Master mode) must have corresponding TRIS bit cleared (output)
+    TRISDbits.RD3=0; //#SS must have corresponding TRIS bit cleared (output)
+    ANSELDbits.ANSD1=0; //Input buffer enabled
+    ANSELDbits.ANSD4=0; //Digital
+    ANSELDbits.ANSD3=0; //Digital
+    ANSELDbits.ANSD0=0; //Digital
+    LATDbits.LATD3=1; //Set SS high so chip is not selected
+
+    PMD1bits.MSSP2MD=0; //Turn on MSSP2 module (SPI2)
+    PMD0bits.SPI2MD=0; //Turn on SPI2
+
+
+    //Clock polarity
+    SSP2CON1bits.CKP=0; //Clock idle low, active high
+    SSP2STATbits.CKE=1; //Active to idle 1
+
+    //Input data sampling
+    SSP2STATbits.SMP=1; //Input data sampled at end of data output time 1
+
+    //SPI Mode and clock
+    SSP2CON1bits.SSPM=CLOCK_SPI_SSPM; //SPI Master Mode, clock = Fosc/CLOCK_SPI_DIVIDER
+
+    //SPI Enable
+    SSP2CON1bits.SSPEN=1; //Enabled
+
+#if LORA_DIO0_WIRED
+    //DIO0 wakes the PIC from SLEEP through INT0.  GIE stays off, so the
+    //PIC carries on after the SLEEP instruction instead of vectoring.
+    LORA_DIO0_TRIS=1; //Input
+    LORA_DIO0_ANSEL=0; //Digital
+    INTCON2bits.INTEDG0=1; //Rising edge
+    INTCONbits.INT0IF=0;
+    INTCONbits.INT0IE=1;
+#endif
+}
+
+/**
+ * Turns SPI2 off as shutdown() does and drops the clock back down.  SS
+ * stays high so the module ignores the bus.  LoRaHALInit brings it back.
+ */
+void LoRaHALDisable(){
+    SSP2CON1bits.SSPEN=0;
+    PMD1bits.MSSP2MD=1; //Turn off MSSP2
+    clockSlow();
+}
+
+/**
+ * Sends one byte on SPI2 and waits for the exchange to finish.
+ * SS must already be low.
+ * @param data byte to send
+ * @return byte received while sending
+ */
+uint8_t LoRaHALTransfer(uint8_t data){
+    SSP2IF=0; //Clear interrupt flag
+    SSP2BUF=data; //Write data to SPI buffer
+    while(!SSP2IF){
+        //Wait for transmission and reception to complete
+    }
+    SSP2IF=0; //Clear interrupt flag
+    return SSP2BUF;
+}
+
+void LoRaHALResetAssert(){
+    TRISAbits.RA2=0; //Configure port as an output
+    LATAbits.LA2=0; //In reset
+}
+
+void LoRaHALResetRelease(){
+    TRISAbits.RA2=1; //Configure port as input (goes high-Z)
+}
+
+/**
+ * Without the DIO0 link the flags DIO0 can be mapped to are read instead.
+ * They're cleared before each operation, so whichever is set is the one
+ * being waited for.  SPI2 must be on.
+ */
+uint8_t LoRaHALDIO0(){
+#if LORA_DIO0_WIRED
+    return LORA_DIO0;
+#else
+    LoRaHALSelect();
+    LoRaHALTransfer(IRQ_FLAGS_REG);
+    uint8_t flags = LoRaHALTransfer(0);
+    LoRaHALDeselect();
+    return (flags & (IRQ_RX_DONE | IRQ_TX_DONE | IRQ_CAD_DONE)) != 0;
+#endif
+}
+
+/**
+ * SLEEP clears the watchdog, so this returns on DIO0 or after at most one
+ * watchdog period.  If DIO0 rose after it was last checked INT0IF is already
+ * set and SLEEP returns straight away.
+ * Without the DIO0 link nothing would end the SLEEP early, leaving the
+ * module in standby for the rest of the 2s, so the flags are polled every
+ * DIO0_POLL_US with the PIC in IDLE in between: the CPU stops and Timer 2,
+ * still clocked, wakes it.  host/lorabattery puts a year of the PIC's
+ * share of the radio at 12.0mAh polling awake against 5.0mAh idling
+ * (CURRENT_PIC_IDLE_MA, an estimate until measured), and 1.4mAh with the
+ * DIO0 link.
+ */
+void LoRaHALSleep(){
+#if LORA_DIO0_WIRED
+    SLEEP();
+    NOP();
+    INTCONbits.INT0IF=0;
+#else
+    //GIE is off, so the PIC carries on after the SLEEP instead of
+    //vectoring.  SLEEP clears the watchdog in IDLE too.
+    PMD0bits.TMR2MD=0; //shutdown() turned Timer 2 off
+    T2CON=0b00000010; //1:1 postscale, 1:16 prescale, stopped
+    PR2=DIO0_POLL_PR2;
+    TMR2=0;
+    PIR1bits.TMR2IF=0;
+    PIE1bits.TMR2IE=1;
+    T2CONbits.TMR2ON=1;
+    OSCCONbits.IDLEN=1; //SLEEP stops the CPU only
+    for(uint16_t polls=0;polls<DIO0_POLLS && !LoRaHALDIO0();polls++){
+        SLEEP();
+        NOP();
+        PIR1bits.TMR2IF=0;
+    }
+    OSCCONbits.IDLEN=0; //Full sleep again for the watchdog wakes
+    T2CONbits.TMR2ON=0;
+    PIE1bits.TMR2IE=0;
+    PMD0bits.TMR2MD=1;
+#endif
+}
@@ -0,0 +1,42 @@
+/*
+ * File:   LoRaHAL.h
+ * Comments: Hardware access layer for the RFM95W on SPI2.
+ * Everything in LoRa.c that touches a PIC register goes through here, so the
+ * driver can also be built on a PC against the simulated SX1276 in host/.
+ * Build with LORA_HOST_SIM defined to use the simulator.
+ */
+
+#ifndef LORAHAL_H
+#define	LORAHAL_H
+
+#include <stdint.h>
+#include "defines.h"
+
+#define DIO0_POLL_US 1000 //Between IRQ flag reads without the DIO0 link
+#define DIO0_POLLS (2000000UL/DIO0_POLL_US) //About one watchdog period
+
+#ifdef LORA_HOST_SIM
+//Simulator versions (host/simSX1276.c)
+void simDelayUs(uint32_t);
+void LoRaHALSelect(void);
+void LoRaHALDeselect(void);
+#define LORA_DELAY_US(x) simDelayUs(x)
+#define LORA_DELAY_MS(x) simDelayUs((uint32_t)(x)*1000UL)
+#else
+#include <xc.h>
+#include "clock.h"
+#define LORA_DELAY_US(x) CLOCK_DELAY_US(x)
+#define LORA_DELAY_MS(x) CLOCK_DELAY_MS(x)
+#define LoRaHALSelect() LATDbits.LATD3=0 //SS low
+#define LoRaHALDeselect() LATDbits.LATD3=1 //SS high
+#endif
+
+void LoRaHALInit(void); //Boosts the clock (clock.h), configures the SPI2 pins and MSSP2 as master
+void LoRaHALDisable(void); //Powers MSSP2 down again between transmissions and drops the clock
+uint8_t LoRaHALTransfer(uint8_t); //Clocks one byte out and returns the byte clocked in
+void LoRaHALResetAssert(void); //Holds the module in reset
+void LoRaHALResetRelease(void); //Lets the reset line float high again
+uint8_t LoRaHALDIO0(void); //Level of the module's DIO0 pin, or the IRQ flags behind it (LORA_DIO0_WIRED, defines.h)
+void LoRaHALSleep(void); //Sleeps the PIC until DIO0 rises or the watchdog wakes it, polls from IDLE without the DIO0 link
+
+#endif	/* LORAHAL_H */
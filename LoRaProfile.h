@@ -0,0 +1,103 @@
+/*
+ * File:   LoRaProfile.h
+ * Comments: Radio profile (spreading factor, bandwidth, coding rate...) used
+ * to build the register table that LoRaOptimalLoad streams to the module.
+ * Each setting can be overridden for a deployment by defining it on the
+ * compiler command line (MPLAB: XC8 compiler > Define macros), e.g. LORA_SF=9.
+ * The checks at the bottom stop a build with a profile the SX1276 can't run,
+ * on the PIC and in the host build alike.
+ */
+
+#ifndef LORAPROFILE_H
+#define	LORAPROFILE_H
+
+#ifndef LORA_SF
+#define LORA_SF 7 //Spreading factor 6 to 12
+#endif
+#ifndef LORA_BW
+#define LORA_BW BW125k //One of the BWxxx values in LoRa.h
+#endif
+#ifndef LORA_CR
+#define LORA_CR 1 //Coding rate 1 to 4 = 4/5 to 4/8
+#endif
+#ifndef LORA_IMPLICIT_HEADER
+#define LORA_IMPLICIT_HEADER 0 //0 = explicit header
+#endif
+#ifndef LORA_CRC_ON
+#define LORA_CRC_ON 0
+#endif
+#ifndef LORA_PREAMBLE
+#define LORA_PREAMBLE 8 //Symbols, module adds 4.25
+#endif
+#ifndef LORA_POWER_DBM
+#define LORA_POWER_DBM 17 //PA_BOOST output, 2 to 17
+#endif
+#ifndef LORA_FREQ_HZ
+#define LORA_FREQ_HZ 868000000UL //Loaded by LoRaOptimalLoad, LoRaStart sets the real one
+#endif
+
+//Bandwidth in Hz for the timing checks
+#if LORA_BW == BW7k8
+#define LORA_BW_HZ 7800L
+#elif LORA_BW == BW10k4
+#define LORA_BW_HZ 10400L
+#elif LORA_BW == BW15k6
+#define LORA_BW_HZ 15600L
+#elif LORA_BW == BW20k8
+#define LORA_BW_HZ 20800L
+#elif LORA_BW == BW31k25
+#define LORA_BW_HZ 31250L
+#elif LORA_BW == BW41k7
+#define LORA_BW_HZ 41700L
+#elif LORA_BW == BW62k5
+#define LORA_BW_HZ 62500L
+#elif LORA_BW == BW125k
+#define LORA_BW_HZ 125000L
+#elif LORA_BW == BW250k
+#define LORA_BW_HZ 250000L
+#elif LORA_BW == BW500k
+#define LORA_BW_HZ 500000L
+#else
+#error "LORA_BW must be one of the BWxxx values in LoRa.h"
+#endif
+
+//Low data rate optimisation is mandatory when a symbol lasts more than 16ms
+//Tsym = 2^SF/BW > 16ms  is the same as  2^SF*125 > 2*BW
+#define LORA_LDRO_NEEDED (((1L<<LORA_SF)*125L) > (2L*LORA_BW_HZ))
+#ifndef LORA_LDRO
+#if LORA_LDRO_NEEDED
+#define LORA_LDRO 1
+#else
+#define LORA_LDRO 0
+#endif
+#endif
+
+//Register values built from the profile
+#define LORA_MODEM_CONFIG_1 ((LORA_BW<<4) | (LORA_CR<<1) | LORA_IMPLICIT_HEADER)
+#define LORA_MODEM_CONFIG_2 ((LORA_SF<<4) | (LORA_CRC_ON<<2))
+#define LORA_MODEM_CONFIG_3 ((LORA_LDRO<<3) | 0x04) //AGC auto on
+#define LORA_PA_CONFIG (0x80 | (LORA_POWER_DBM - 2)) //PA_BOOST pin
+#define LORA_PREAMBLE_MSB ((LORA_PREAMBLE>>8) & 0xFF)
+#define LORA_PREAMBLE_LSB (LORA_PREAMBLE & 0xFF)
+
+//Profile checks
+#if LORA_SF < 6 || LORA_SF > 12
+#error "LORA_SF must be 6 to 12"
+#endif
+#if LORA_SF == 6 && !LORA_IMPLICIT_HEADER
+#error "SF6 only works with an implicit header"
+#endif
+#if LORA_CR < 1 || LORA_CR > 4
+#error "LORA_CR must be 1 (4/5) to 4 (4/8)"
+#endif
+#if LORA_LDRO_NEEDED && !LORA_LDRO
+#error "LORA_LDRO must be on when a symbol lasts more than 16ms"
+#endif
+#if LORA_POWER_DBM < 2 || LORA_POWER_DBM > 17
+#error "LORA_POWER_DBM must be 2 to 17"
+#endif
+#if LORA_PREAMBLE < 6 || LORA_PREAMBLE > 65535
+#error "LORA_PREAMBLE must be 6 to 65535 symbols"
+#endif
+
+#endif	/* LORAPROFILE_H */
@@ -0,0 +1,31 @@
+/*
+ * File:   clock.c
+ * System clock switching, see clock.h.
+ * The rate is only ever in OSCCON, so there's nothing to get out of step
+ * after a reset.
+ */
+#include <xc.h>
+#include "clock.h"
+
+/**
+ * Internal oscillator block as the system clock, PLL off, at the fast
+ * rate.  main() drops to the slow rate once the radio is set up.
+ */
+void clockInit(){
+    OSCTUNEbits.PLLEN=0; //No 4x PLL, PLLCFG is off in config.h too
+    OSCCON2bits.MFIOSEL=0; //Slow rates from HFINTOSC, not MFINTOSC
+    OSCCONbits.SCS=0b00; //Clock set by FOSC, the internal block
+    clockBoost();
+}
+
+void clockBoost(){
+    OSCCONbits.IRCF=CLOCK_FAST_IRCF;
+}
+
+void clockSlow(){
+    OSCCONbits.IRCF=CLOCK_SLOW_IRCF;
+}
+
+uint8_t clockBoosted(){
+    return OSCCONbits.IRCF == CLOCK_FAST_IRCF;
+}
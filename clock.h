@@ -0,0 +1,69 @@
+/*
+ * File:   clock.h
+ * Comments: System clock management.  Bookkeeping on the watchdog wakes
+ * runs on CLOCK_SLOW and the clock goes up to CLOCK_FAST only for the
+ * radio: LoRaHALInit boosts it and LoRaHALDisable drops it again, so the
+ * SPI divider can be picked for the fast clock alone.
+ * CLOCK_SLOW is the fast rate unless set lower.  The bookkeeping is
+ * instruction bound, and the part of the PIC's current that doesn't scale
+ * with the clock makes each instruction cost more charge the slower it
+ * runs: host/lorabattery puts a year of wakes at 1.4mAh at 16MHz, 1.5mAh
+ * at 8MHz and 3.1mAh at 1MHz.  A slower rate only pays for work that
+ * waits a fixed time.  make -C host check runs the firmware with
+ * CLOCK_SLOW_IRCF 0b011 so the switching is kept working.
+ * Both rates come from HFINTOSC through its postscaler, so a switch takes
+ * a few cycles and HFOFST (config.h) means there's no stable wait.  The
+ * 4x PLL stays off: it needs up to 2ms to lock on every boost and VDD
+ * above 2.7V, which 2 x C cells don't hold to the end.
+ * _XTAL_FREQ is CLOCK_FAST_HZ, so __delay_us and __delay_ms are only right
+ * while boosted.  CLOCK_DELAY_US and CLOCK_DELAY_MS are right at either
+ * rate, never short, and are what the driver uses.
+ * With logging on the slow clock is the fast one, as the UART baud rate
+ * is worked out for _XTAL_FREQ (log.c).
+ */
+
+#ifndef CLOCK_H
+#define	CLOCK_H
+
+#include <stdint.h>
+#include "defines.h"
+#include "log.h"
+
+#define CLOCK_FAST_HZ _XTAL_FREQ
+#define CLOCK_FAST_IRCF 0b111 //16MHz HFINTOSC
+#ifndef CLOCK_SLOW_IRCF
+#define CLOCK_SLOW_IRCF CLOCK_FAST_IRCF //0b011 for 1MHz
+#endif
+#if LOG_LEVEL > LOG_LEVEL_NONE
+#undef CLOCK_SLOW_IRCF
+#define CLOCK_SLOW_IRCF CLOCK_FAST_IRCF //UART baud rate is for _XTAL_FREQ
+#endif
+#define CLOCK_SLOW_HZ (CLOCK_FAST_HZ >> (CLOCK_FAST_IRCF - CLOCK_SLOW_IRCF)) //Postscaler halves per step down to IRCF 001
+
+#ifndef CLOCK_SPI_SSPM
+#define CLOCK_SPI_SSPM 0b0000 //SPI master, Fosc/4: 4MHz at 16MHz
+#endif
+#define CLOCK_SPI_DIVIDER (CLOCK_SPI_SSPM == 0b0000 ? 4 : CLOCK_SPI_SSPM == 0b0001 ? 16 : 64)
+#define CLOCK_SPI_MAX_HZ 10000000UL //SX1276 FSCK
+
+#if CLOCK_SLOW_IRCF < 1 || CLOCK_SLOW_IRCF > CLOCK_FAST_IRCF
+#error CLOCK_SLOW_IRCF must be 1 (250kHz) to 7 (16MHz)
+#endif
+#if CLOCK_SPI_SSPM > 0b0010
+#error CLOCK_SPI_SSPM must be an SPI master Fosc divider (0 to 2)
+#endif
+#if CLOCK_FAST_HZ/CLOCK_SPI_DIVIDER > CLOCK_SPI_MAX_HZ
+#error SPI clock too fast for the SX1276
+#endif
+
+//Instruction cycles for a delay, rounded up and at least 1
+#define CLOCK_CYCLES(us, hz) ((unsigned long)((us)*((hz)/4000000.0)) + 1)
+#define CLOCK_DELAY_US(x) do{ if(clockBoosted()) _delay(CLOCK_CYCLES(x, CLOCK_FAST_HZ)); else _delay(CLOCK_CYCLES(x, CLOCK_SLOW_HZ)); }while(0)
+#define CLOCK_DELAY_MS(x) do{ for(uint16_t ms_=0;ms_<(x);ms_++){ CLOCK_DELAY_US(1000); } }while(0)
+
+void clockInit(void); //PLL off, boosted for start up
+void clockBoost(void); //Up to CLOCK_FAST for SPI and radio work
+void clockSlow(void); //Back down to CLOCK_SLOW
+uint8_t clockBoosted(void);
+
+#endif	/* CLOCK_H */
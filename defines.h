@@ -1,16 +1,26 @@
-/* Author: Andy Page
- * Comments: defines.h
- * Revision history: 1, 9th January 2022
- */
-
-// This is a guard condition so that contents of this file are not included
-// more than once.  
-#ifndef INC_DEFINES_H
-#define	INC_DEFINES_H
-
-#define _XTAL_FREQ 16000000
-#define GREEN_LED LATEbits.LATE1 //Green LED output port
-#define RED_LED LATEbits.LATE2 //Red LED output port
-
-
+/* Author: Andy Page
+ * Comments: defines.h
+ * Revision history: 1, 9th January 2022
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.  
+#ifndef INC_DEFINES_H
+#define	INC_DEFINES_H
+
+#define _XTAL_FREQ 16000000
+#define GREEN_LED LATEbits.LATE1 //Green LED output port
+#define RED_LED LATEbits.LATE2 //Red LED output port
+//SCH000044r1 takes the RFM95W's DIO0 to pad P44 only, and RB0 to pad P14.
+//With a link fitted between them define LORA_DIO0_WIRED 1 and TxDone wakes
+//the PIC on INT0.  Without it RB0 stays a driven output and LoRaHALDIO0
+//reads the IRQ flags over SPI instead.
+#ifndef LORA_DIO0_WIRED
+#define LORA_DIO0_WIRED 0
+#endif
+#define LORA_DIO0 PORTBbits.RB0 //RFM95W DIO0 on INT0 so TxDone can wake the PIC
+#define LORA_DIO0_TRIS TRISBbits.RB0
+#define LORA_DIO0_ANSEL ANSELBbits.ANSB0
+
+
 #endif	/* INC_DEFINES_H */
\ No newline at end of file
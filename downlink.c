@@ -0,0 +1,159 @@
+/*
+ * File:   downlink.c
+ * Receive window and command handling, see downlink.h.
+ * XTEA (32 cycles) is small and fast enough on the PIC for one block per
+ * 8 bytes of command.  The length is enciphered first, as its own block,
+ * so CBC-MAC stays sound for commands of different lengths.
+ */
+#include "downlink.h"
+#include "settings.h"
+#include "report.h"
+#include "frame.h"
+#include "LoRa.h"
+#include "log.h"
+
+static const uint32_t key[4] = {DOWNLINK_KEY};
+static uint8_t sinceWindow; //Transmissions since the last receive window
+
+static void xtea(uint32_t* v){
+    uint32_t v0 = v[0];
+    uint32_t v1 = v[1];
+    uint32_t sum = 0;
+    for(uint8_t i=0;i<32;i++){
+        v0 += (((v1<<4) ^ (v1>>5)) + v1) ^ (sum + key[sum & 3]);
+        sum += 0x9E3779B9UL;
+        v1 += (((v0<<4) ^ (v0>>5)) + v0) ^ (sum + key[(sum>>11) & 3]);
+    }
+    v[0] = v0;
+    v[1] = v1;
+}
+
+/**
+ * CBC-MAC of data, the last block padded with zeros.
+ * @param mac DOWNLINK_MAC_LENGTH bytes out
+ */
+static void cbcMac(uint8_t* mac, const uint8_t* data, uint8_t length){
+    uint32_t v[2];
+    v[0] = length;
+    v[1] = 0;
+    xtea(v);
+    for(uint8_t i=0;i<length;i+=8){
+        for(uint8_t j=0;j<8 && i+j<length;j++){
+            v[j>>2] ^= (uint32_t)data[i+j] << (24 - 8*(j & 3));
+        }
+        xtea(v);
+    }
+    for(uint8_t i=0;i<DOWNLINK_MAC_LENGTH;i++){
+        mac[i] = v[0] >> (24 - 8*i);
+    }
+}
+
+/**
+ * @param buffer command up to the MAC, with room for DOWNLINK_MAC_LENGTH more
+ * @param length bytes in buffer
+ * @return length with the MAC
+ */
+uint8_t downlinkSeal(uint8_t* buffer, uint8_t length){
+    cbcMac(buffer + length, buffer, length);
+    return length + DOWNLINK_MAC_LENGTH;
+}
+
+/**
+ * Checks a received command and carries it out.
+ * @param buffer
+ * @param length
+ * @return DOWNLINK_OK or what was wrong with it
+ */
+uint8_t downlinkApply(const uint8_t* buffer, uint8_t length){
+    uint8_t mac[DOWNLINK_MAC_LENGTH];
+    uint8_t difference = 0;
+    if(length < DOWNLINK_MIN_LENGTH || length > DOWNLINK_MAX_LENGTH || (length & 1)){
+        return DOWNLINK_BAD_LENGTH;
+    }
+    if(buffer[0] != DOWNLINK_VERSION<<5){
+        return DOWNLINK_BAD_VERSION;
+    }
+    if(buffer[1] != REPORT_NODE_ID && buffer[1] != DOWNLINK_ALL_NODES){
+        return DOWNLINK_OTHER_NODE;
+    }
+    length -= DOWNLINK_MAC_LENGTH;
+    cbcMac(mac, buffer, length);
+    for(uint8_t i=0;i<DOWNLINK_MAC_LENGTH;i++){
+        difference |= mac[i] ^ buffer[length+i]; //Same time whichever byte is wrong
+    }
+    if(difference){
+        return DOWNLINK_BAD_MAC;
+    }
+    Settings next = settings;
+    next.downlinkCounter = (uint16_t)buffer[3]<<8 | buffer[2];
+    if((int16_t)(next.downlinkCounter - settings.downlinkCounter) <= 0){
+        return DOWNLINK_REPLAY;
+    }
+    uint8_t backfill = 0;
+    uint8_t backfillFrom = 0;
+    for(uint8_t i=4;i<length;i+=2){
+        uint8_t value = buffer[i+1];
+        switch(buffer[i]){
+            case DOWNLINK_BATCH:
+                next.batchMinutes = value;
+                break;
+            case DOWNLINK_SF:
+                next.spreadingFactor = value;
+                break;
+            case DOWNLINK_POWER:
+                next.powerDbm = value;
+                break;
+            case DOWNLINK_LISTEN_EVERY:
+                next.downlinkEvery = value;
+                break;
+            case DOWNLINK_BACKFILL:
+                backfill = 1;
+                backfillFrom = value;
+                break;
+            default:
+                return DOWNLINK_BAD_COMMAND;
+        }
+    }
+    if(!settingsValid(&next)){
+        return DOWNLINK_BAD_COMMAND;
+    }
+    if(!settingsSave(&next)){
+        return DOWNLINK_NOT_STORED;
+    }
+    settingsApplyRadio();
+    if(backfill){
+        reportBackfill(backfillFrom);
+    }
+    reportFlag(FRAME_STATUS_CONFIGURED);
+    return DOWNLINK_OK;
+}
+
+/**
+ * Opens the receive window if it's due.  A symbol timeout is worked out
+ * from DOWNLINK_WINDOW_MS, so the window lasts as long at any spreading
+ * factor.
+ * @return DOWNLINK_OK, DOWNLINK_NONE if no window or nothing heard, or what
+ * was wrong with the command
+ */
+uint8_t downlinkListen(){
+    uint8_t buffer[DOWNLINK_MAX_LENGTH];
+    sinceWindow++;
+    if(sinceWindow < settings.downlinkEvery){
+        return DOWNLINK_NONE;
+    }
+    sinceWindow = 0;
+    uint32_t symbols = DOWNLINK_WINDOW_MS*1000UL/LoRaSymbolUs();
+    if(symbols < DOWNLINK_MIN_SYMBOLS){
+        symbols = DOWNLINK_MIN_SYMBOLS;
+    }
+    if(symbols > 1023){
+        symbols = 1023; //Largest the module takes
+    }
+    uint8_t length = LoRaRXSingle(buffer, sizeof(buffer), symbols);
+    if(length == 0){
+        return DOWNLINK_NONE;
+    }
+    uint8_t result = downlinkApply(buffer, length);
+    TRACE(TRACE_DOWNLINK, result);
+    return result;
+}
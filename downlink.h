@@ -0,0 +1,69 @@
+/*
+ * File:   downlink.h
+ * Comments: Remote reconfiguration.  After every settings.downlinkEvery
+ * transmissions the radio listens once, straight after TxDone, for
+ * DOWNLINK_WINDOW_MS.  The receiver has to start its reply inside that
+ * window, on the same channel and settings as the frame it heard.
+ * Command format, low byte first throughout:
+ *   header   version in bits 7-5, rest 0
+ *   node     REPORT_NODE_ID, or DOWNLINK_ALL_NODES
+ *   counter  16 bits, must be newer than the last one accepted
+ *   commands code and value pairs, DOWNLINK_xxx below
+ *   MAC      4 bytes, XTEA CBC-MAC over everything before it
+ * A command is taken whole or not at all: every value is checked and the
+ * new settings (settings.h), counter included, stored in EEPROM before any
+ * of it is acted on.  The next record sent has FRAME_STATUS_CONFIGURED
+ * set so the receiver knows it got through.
+ * DOWNLINK_EVERY 0 builds without the receive window.  Set DOWNLINK_KEY
+ * for each deployment; the default is only for the bench.
+ */
+
+#ifndef DOWNLINK_H
+#define	DOWNLINK_H
+
+#include <stdint.h>
+
+#ifndef DOWNLINK_EVERY
+#define DOWNLINK_EVERY 0 //Transmissions per receive window, 0 for none
+#endif
+#ifndef DOWNLINK_WINDOW_MS
+#define DOWNLINK_WINDOW_MS 100 //Time the reply has to start in
+#endif
+#ifndef DOWNLINK_KEY
+#define DOWNLINK_KEY 0x4C6F5261UL, 0x57696E64UL, 0x42656E63UL, 0x68204B65UL //128 bit XTEA key
+#endif
+
+#define DOWNLINK_VERSION 1
+#define DOWNLINK_ALL_NODES 0
+#define DOWNLINK_MAC_LENGTH 4
+#define DOWNLINK_MIN_LENGTH (4 + DOWNLINK_MAC_LENGTH)
+#define DOWNLINK_MAX_LENGTH (DOWNLINK_MIN_LENGTH + 2*8) //Up to 8 commands
+#define DOWNLINK_MIN_SYMBOLS 4 //Shortest symbol timeout, enough to catch a preamble
+
+//Command codes, each followed by one value byte
+#define DOWNLINK_BATCH 1 //Minutes per frame, 1 to FRAME_MAX_RECORDS
+#define DOWNLINK_SF 2 //Spreading factor, 7 to 12
+#define DOWNLINK_POWER 3 //dBm, 2 to 17
+#define DOWNLINK_LISTEN_EVERY 4 //Transmissions per receive window, at least 1
+#define DOWNLINK_BACKFILL 5 //Frame sequence number to send again from
+
+//Results
+#define DOWNLINK_OK 0
+#define DOWNLINK_NONE 1 //Nothing received
+#define DOWNLINK_BAD_LENGTH 2
+#define DOWNLINK_BAD_VERSION 3
+#define DOWNLINK_OTHER_NODE 4
+#define DOWNLINK_BAD_MAC 5
+#define DOWNLINK_REPLAY 6
+#define DOWNLINK_BAD_COMMAND 7 //Unknown code or value out of range
+#define DOWNLINK_NOT_STORED 8 //Supply too low to write the EEPROM
+
+#if DOWNLINK_EVERY < 0 || DOWNLINK_EVERY > 255
+#error DOWNLINK_EVERY must be 0 to 255
+#endif
+
+uint8_t downlinkListen(void); //Call after each transmission, module asleep and SPI2 on.  DOWNLINK_xxx result.
+uint8_t downlinkApply(const uint8_t*, uint8_t); //Checks and acts on a received command.  DOWNLINK_xxx result.
+uint8_t downlinkSeal(uint8_t*, uint8_t); //Appends the MAC to a command, for the receiver end.  Returns the new length.
+
+#endif	/* DOWNLINK_H */
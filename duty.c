@@ -0,0 +1,50 @@
+/*
+ * File:   duty.c
+ * Air time token bucket, see duty.h.
+ */
+#include "duty.h"
+
+static uint32_t tokens; //Microseconds of air time available
+static uint16_t lastTick;
+
+void dutyInit(uint16_t now){
+    tokens = 0;
+    lastTick = now;
+}
+
+static void refill(uint16_t now){
+    uint16_t ticks = now - lastTick;
+    lastTick = now;
+    if(ticks >= DUTY_BURST_US/DUTY_REFILL_US){
+        tokens = DUTY_BURST_US; //Also keeps the multiply below in range
+        return;
+    }
+    tokens += ticks*DUTY_REFILL_US;
+    if(tokens > DUTY_BURST_US){
+        tokens = DUTY_BURST_US;
+    }
+}
+
+/**
+ * Checks a transmission against the bucket.  Doesn't take anything out,
+ * use dutySpend once it's been sent.
+ * @param now scheduler tick
+ * @param airUs time on air, see LoRaTimeOnAir
+ * @param priority DUTY_LOW frames must leave DUTY_RESERVE_US behind
+ * @return 1 if it can be sent now
+ */
+uint8_t dutyAllow(uint16_t now, uint32_t airUs, uint8_t priority){
+    refill(now);
+    if(priority == DUTY_LOW){
+        airUs += DUTY_RESERVE_US;
+    }
+    return tokens >= airUs;
+}
+
+void dutySpend(uint32_t airUs){
+    tokens = airUs > tokens ? 0 : tokens - airUs;
+}
+
+uint32_t dutyAvailable(){
+    return tokens;
+}
@@ -0,0 +1,39 @@
+/*
+ * File:   duty.h
+ * Comments: Duty cycle governor for the EU868 865-868MHz sub-band, 1% of
+ * any hour (36s) on air.
+ * A token bucket of air time: it fills a little on every watchdog tick and
+ * each transmission takes its time on air out.  A full bucket could be
+ * spent in a burst on top of an hour's refill, so the refill rate is cut
+ * to leave room for it: DUTY_BURST_US + one hour of refill stays within
+ * DUTY_HOUR_US in any hour.  The watchdog period is also taken as
+ * DUTY_WDT_MARGIN percent of nominal since LFINTOSC may run fast; time
+ * spent awake only makes the real period longer.
+ * Routine frames must leave DUTY_RESERVE_US in the bucket so a gust can
+ * still get out.
+ * The bucket starts empty, since the sensor may have been transmitting
+ * just before a reset.
+ */
+
+#ifndef DUTY_H
+#define	DUTY_H
+
+#include <stdint.h>
+#include "scheduler.h"
+
+#define DUTY_HOUR_US 36000000UL //1% of an hour
+#define DUTY_BURST_US 3600000UL //Bucket size
+#define DUTY_RESERVE_US 1000000UL //Kept back for DUTY_HIGH frames
+#define DUTY_WDT_MARGIN 85 //Percent
+#define DUTY_TICKS_PER_HOUR (3600000UL/SCHED_TICK_MS)
+#define DUTY_REFILL_US ((DUTY_HOUR_US - DUTY_BURST_US)/DUTY_TICKS_PER_HOUR*DUTY_WDT_MARGIN/100) //Per tick
+
+#define DUTY_LOW 0 //Routine frame
+#define DUTY_HIGH 1 //May use the reserve
+
+void dutyInit(uint16_t); //Scheduler tick now
+uint8_t dutyAllow(uint16_t, uint32_t, uint8_t); //Tick now, time on air, DUTY_LOW or DUTY_HIGH.  1 if it can be sent.
+void dutySpend(uint32_t); //Time on air actually used
+uint32_t dutyAvailable(void); //Microseconds of air time in the bucket
+
+#endif	/* DUTY_H */
@@ -0,0 +1,161 @@
+/*
+ * File:   eelog.c
+ * Data EEPROM ring log, see eelog.h.
+ * Slot layout: sequence low, sequence high, total low, total high,
+ * gust low, gust high, spread low, spread high, status, check (bit inverse of the sum of the rest).
+ * Erased EEPROM (all 0xFF) fails the check.
+ * EELOG_SLOTS isn't a power of 2, so slots are found from the full 16 bit
+ * sequence number.  When that wraps to 0 the first few slots are reused
+ * early, which only shortens the log for a while.
+ */
+#include "eelog.h"
+#include "eeprom.h"
+
+static uint16_t nextSequence; //For the next record appended
+static WindFrame queue[EELOG_QUEUE];
+static uint8_t queueCount;
+
+/**
+ * Reads a slot.
+ * @return 1 if it holds a valid record
+ */
+static uint8_t readSlot(uint8_t slot, uint16_t* sequence, WindFrame* record){
+    uint8_t bytes[EELOG_SLOT_SIZE];
+    uint8_t sum = 0;
+    uint16_t address = (uint16_t)slot*EELOG_SLOT_SIZE;
+    for(uint8_t i=0;i<EELOG_SLOT_SIZE;i++){
+        bytes[i] = eepromRead(address+i);
+        sum += bytes[i];
+    }
+    if(sum != 0xFF){ //The last byte is the complement of the sum of the rest
+        return 0;
+    }
+    *sequence = (uint16_t)bytes[1]<<8 | bytes[0];
+    if((*sequence % EELOG_SLOTS) != slot){
+        return 0;
+    }
+    if(record){
+        record->sequence = bytes[0];
+        record->total = (uint16_t)bytes[3]<<8 | bytes[2];
+        record->gust = (uint16_t)bytes[5]<<8 | bytes[4];
+        record->spread = (uint16_t)bytes[7]<<8 | bytes[6];
+        record->status = bytes[8];
+        record->supply = 0; //Goes with the frame, not the minute
+        record->held = 0;
+    }
+    return 1;
+}
+
+static void writeSlot(uint16_t sequence, const WindFrame* record){
+    uint8_t bytes[EELOG_SLOT_SIZE];
+    uint8_t sum = 0;
+    uint16_t address = (sequence % EELOG_SLOTS)*EELOG_SLOT_SIZE;
+    bytes[0] = sequence & 0xFF;
+    bytes[1] = sequence>>8;
+    bytes[2] = record->total & 0xFF;
+    bytes[3] = record->total>>8;
+    bytes[4] = record->gust & 0xFF;
+    bytes[5] = record->gust>>8;
+    bytes[6] = record->spread & 0xFF;
+    bytes[7] = record->spread>>8;
+    bytes[8] = record->status;
+    for(uint8_t i=0;i<EELOG_SLOT_SIZE-1;i++){
+        sum += bytes[i];
+    }
+    bytes[EELOG_SLOT_SIZE-1] = ~sum;
+    //Check byte last, so the slot only becomes valid once the rest is in
+    for(uint8_t i=0;i<EELOG_SLOT_SIZE;i++){
+        eepromWrite(address+i, bytes[i]);
+    }
+}
+
+/**
+ * Finds the newest record: a valid slot whose successor doesn't hold the
+ * next sequence number.  Takes about 2000 EEPROM reads.
+ * @return sequence number for the next record, 0 on an empty log
+ */
+uint16_t eelogInit(){
+    uint8_t found = 0;
+    uint16_t newest = 0;
+    uint16_t sequence;
+    uint16_t following;
+    for(uint8_t slot=0;slot<EELOG_SLOTS;slot++){
+        if(!readSlot(slot, &sequence, 0)){
+            continue;
+        }
+        uint8_t next = (slot+1) % EELOG_SLOTS;
+        if(readSlot(next, &following, 0) && following == (uint16_t)(sequence+1)){
+            continue; //Not the end of the run
+        }
+        if(!found || (int16_t)(sequence - newest) > 0){
+            newest = sequence;
+            found = 1;
+        }
+    }
+    nextSequence = found ? newest+1 : 0;
+    queueCount = 0;
+    return nextSequence;
+}
+
+/**
+ * Queues a record.  If the queue is full because the supply has been too
+ * low to flush, the oldest queued record is dropped.
+ * @param record its sequence number must be the low byte of the one eelogInit returned, counting on
+ */
+void eelogAppend(const WindFrame* record){
+    if(queueCount >= EELOG_QUEUE){
+        for(uint8_t i=1;i<EELOG_QUEUE;i++){
+            queue[i-1] = queue[i];
+        }
+        queueCount--;
+    }
+    queue[queueCount++] = *record;
+    nextSequence++;
+}
+
+uint8_t eelogQueued(){
+    return queueCount;
+}
+
+/**
+ * Writes all queued records.  About 32ms per record, asleep for most of it.
+ * @return 1 if written, 0 if the supply is too low (the queue is kept)
+ */
+uint8_t eelogFlush(){
+    if(queueCount == 0){
+        return 1;
+    }
+    if(!eepromSupplyOK()){
+        return 0;
+    }
+    uint16_t sequence = nextSequence - queueCount;
+    for(uint8_t i=0;i<queueCount;i++){
+        writeSlot(sequence+i, &queue[i]);
+    }
+    queueCount = 0;
+    return 1;
+}
+
+/**
+ * Looks a record up by frame sequence number.  Only the last EELOG_SLOTS
+ * records are held, so an 8 bit sequence number is enough.
+ * @param sequence
+ * @param record filled in if found, node not set
+ * @return 1 if found
+ */
+uint8_t eelogRead(uint8_t sequence, WindFrame* record){
+    uint16_t stored;
+    uint8_t back = (uint8_t)nextSequence - sequence; //Records ago, 1 is the newest
+    if(back == 0 || back > EELOG_SLOTS){
+        return 0;
+    }
+    if(back <= queueCount){
+        *record = queue[queueCount-back];
+        return 1;
+    }
+    uint16_t wanted = nextSequence - back;
+    if(!readSlot(wanted % EELOG_SLOTS, &stored, record)){
+        return 0;
+    }
+    return stored == wanted;
+}
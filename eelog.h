@@ -0,0 +1,35 @@
+/*
+ * File:   eelog.h
+ * Comments: Store and forward log of wind records in the data EEPROM.
+ * Each record has a 10 byte slot: 16 bit sequence number, total, gust,
+ * spread, status and a check byte, so a write torn by a brown out reads as empty.
+ * Record n always goes in slot n % EELOG_SLOTS, which makes the log a ring
+ * that wears every slot evenly (each written once per 100 records, about
+ * 19 years at one a minute for 100k cycles) and lets eelogInit find the
+ * newest record without any pointer being stored.
+ * Appended records wait in RAM until eelogFlush writes them in one go, and
+ * only if the supply is above the HLVD trip point.  The PIC sleeps through
+ * each byte write.
+ * The sequence numbers carry on across power cycles, the low byte is the
+ * frame sequence number.
+ */
+
+#ifndef EELOG_H
+#define	EELOG_H
+
+#include <stdint.h>
+#include "frame.h"
+#include "eeprom.h"
+
+#define EELOG_SLOT_SIZE 10
+#define EELOG_SLOTS (EEPROM_SETTINGS/EELOG_SLOT_SIZE) //100
+#define EELOG_QUEUE FRAME_MAX_RECORDS //Records held in RAM until eelogFlush
+#define EELOG_FLUSH_AT 5 //Queued records worth waking the EEPROM for
+
+uint16_t eelogInit(void); //Finds the newest record.  Returns the sequence number for the next one.
+void eelogAppend(const WindFrame*); //Queues the record for the next sequence number
+uint8_t eelogQueued(void); //Records waiting for eelogFlush
+uint8_t eelogFlush(void); //Writes the queue to EEPROM.  Returns 0 if the supply was too low.
+uint8_t eelogRead(uint8_t, WindFrame*); //Record by frame sequence number from the queue or EEPROM.  Returns 0 if it isn't held.
+
+#endif	/* EELOG_H */
@@ -0,0 +1,64 @@
+/*
+ * File:   eeprom.c
+ * Data EEPROM access, see eeprom.h.
+ */
+#include <xc.h>
+#include "eeprom.h"
+
+#define HLVD_TRIP 0b0011 //About 2.2V, well clear of the EEPROM minimum
+
+uint8_t eepromRead(uint16_t address){
+    EEADRH = address>>8;
+    EEADR = address & 0xFF;
+    EECON1bits.EEPGD=0; //Data EEPROM
+    EECON1bits.CFGS=0;
+    EECON1bits.RD=1;
+    return EEDATA;
+}
+
+/**
+ * Writes one byte, sleeping until the write completes (about 4ms).  EEIF
+ * wakes the PIC, GIE is off so there is no interrupt routine.
+ * Unchanged bytes are skipped to save the time and the wear.
+ */
+void eepromWrite(uint16_t address, uint8_t value){
+    if(eepromRead(address) == value){
+        return;
+    }
+    EEDATA = value;
+    EECON1bits.WREN=1;
+    PIR2bits.EEIF=0;
+    PIE2bits.EEIE=1;
+    EECON2=0x55; //Unlock sequence
+    EECON2=0xAA;
+    EECON1bits.WR=1;
+    while(EECON1bits.WR){
+        SLEEP(); //Woken by EEIF, or the watchdog
+        NOP();
+    }
+    EECON1bits.WREN=0;
+    PIE2bits.EEIE=0;
+    PIR2bits.EEIF=0;
+}
+
+/**
+ * Uses the HLVD module to check VDD is above HLVD_TRIP, then turns it off
+ * again as it draws current while enabled.
+ * @return 1 if it's safe to write
+ */
+uint8_t eepromSupplyOK(){
+    HLVDCONbits.HLVDEN=0;
+    HLVDCONbits.VDIRMAG=0; //Flag VDD falling below the trip point
+    HLVDCONbits.HLVDL=HLVD_TRIP;
+    HLVDCONbits.HLVDEN=1;
+    while(!HLVDCONbits.IRVST){
+        //Reference settling
+    }
+    PIR2bits.HLVDIF=0;
+    NOP();
+    NOP();
+    uint8_t ok = !PIR2bits.HLVDIF;
+    HLVDCONbits.HLVDEN=0;
+    PIR2bits.HLVDIF=0;
+    return ok;
+}
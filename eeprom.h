@@ -0,0 +1,22 @@
+/*
+ * File:   eeprom.h
+ * Comments: Byte access to the 1KB data EEPROM and the map of what lives
+ * where.  The wind record log (eelog.h) has everything below
+ * EEPROM_SETTINGS, the remote settings (settings.h) the 16 bytes above.
+ * Writes sleep the PIC until they complete and skip bytes that already
+ * hold the value.  Check eepromSupplyOK before a run of writes.
+ */
+
+#ifndef EEPROM_H
+#define	EEPROM_H
+
+#include <stdint.h>
+
+#define EEPROM_SIZE 1024
+#define EEPROM_SETTINGS 0x3F0 //Two 8 byte copies of the settings
+
+uint8_t eepromRead(uint16_t);
+void eepromWrite(uint16_t, uint8_t); //About 4ms, asleep, unless the byte is unchanged
+uint8_t eepromSupplyOK(void); //1 if VDD is high enough to write
+
+#endif	/* EEPROM_H */
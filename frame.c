@@ -0,0 +1,245 @@
+/*
+ * File:   frame.c
+ * Encoder and decoder for the wind frame, see frame.h.
+ * Plain C with no hardware access so the receiver and the host tools build
+ * the same file.  XC8 leaves frameDecode out of the sensor image as nothing
+ * calls it.
+ */
+#include "frame.h"
+
+static uint8_t putVarint(uint8_t* buffer, uint16_t value){
+    uint8_t length = 0;
+    while(value >= 0x80){
+        buffer[length++] = (value & 0x7F) | 0x80;
+        value >>= 7;
+    }
+    buffer[length++] = value;
+    return length;
+}
+
+static uint8_t varintLength(uint16_t value){
+    uint8_t length = 1;
+    while(value >= 0x80){
+        value >>= 7;
+        length++;
+    }
+    return length;
+}
+
+/**
+ * Reads a varint of at most 3 bytes (16 bits).
+ * @return bytes used, 0 if it runs past the end, is too long or the third
+ * byte carries bits above bit 15
+ */
+static uint8_t getVarint(const uint8_t* buffer, uint8_t available, uint16_t* value){
+    uint16_t result = 0;
+    for(uint8_t i=0;i<3 && i<available;i++){
+        if(i == 2 && buffer[2] > 0x03){
+            return 0; //Would overflow 16 bits, or carries on
+        }
+        result |= (uint16_t)(buffer[i] & 0x7F) << (7*i);
+        if(!(buffer[i] & 0x80)){
+            *value = result;
+            return i+1;
+        }
+    }
+    return 0;
+}
+
+//Small differences either way become small numbers: 0,-1,1,-2.. -> 0,1,2,3..
+static uint16_t zigzag(uint16_t current, uint16_t previous){
+    uint16_t delta = current - previous; //Wraps, so any pair works
+    return (delta & 0x8000) ? (uint16_t)~(delta << 1) : (uint16_t)(delta << 1);
+}
+
+static uint16_t unzigzag(uint16_t value, uint16_t previous){
+    uint16_t delta = (value & 1) ? (uint16_t)~(value >> 1) : (uint16_t)(value >> 1);
+    return previous + delta;
+}
+
+/**
+ * Encodes records for consecutive minutes into one frame.  The first is
+ * sent as a delta from previous when that is shorter.  previous must be the
+ * last record sent, its sequence number one behind the first.  Status bits
+ * from every record are sent, and the last supply voltage any of them has.
+ * The held count is the first record's.
+ * @param buffer at least FRAME_MAX_LENGTH bytes
+ * @param frames node and sequence are taken from the first
+ * @param count 1 to FRAME_MAX_RECORDS
+ * @param previous 0 for an absolute frame
+ * @return frame length in bytes
+ */
+uint8_t frameEncode(uint8_t* buffer, const WindFrame* frames, uint8_t count, const WindFrame* previous){
+    uint8_t flags = 0;
+    uint8_t status = 0;
+    uint16_t supply = 0;
+    uint16_t total = frames[0].total;
+    uint16_t gust = frames[0].gust;
+    if(previous){
+        uint16_t deltaTotal = zigzag(total, previous->total);
+        uint16_t deltaGust = zigzag(gust, previous->gust);
+        if(varintLength(deltaTotal) + varintLength(deltaGust) <
+                varintLength(total) + varintLength(gust)){
+            flags |= FRAME_DELTA;
+            total = deltaTotal;
+            gust = deltaGust;
+        }
+    }
+    for(uint8_t i=0;i<count;i++){
+        status |= frames[i].status;
+        if(frames[i].supply){
+            supply = frames[i].supply;
+        }
+        if(frames[i].spread){
+            flags |= FRAME_SPREAD;
+        }
+    }
+    status &= ~FRAME_STATUS_HELD;
+    if(frames[0].held){
+        status |= FRAME_STATUS_HELD;
+    }
+    if(status){
+        flags |= FRAME_STATUS;
+    }
+    if(supply){
+        flags |= FRAME_SUPPLY;
+    }
+    if(count > 1){
+        flags |= FRAME_BATCH;
+    }
+    buffer[0] = FRAME_VERSION<<FRAME_VERSION_SHIFT | flags;
+    buffer[1] = frames[0].node;
+    buffer[2] = frames[0].sequence;
+    uint8_t length = 3;
+    if(flags & FRAME_BATCH){
+        buffer[length++] = count;
+    }
+    for(uint8_t i=0;i<count;i++){
+        if(i > 0){
+            total = zigzag(frames[i].total, frames[i-1].total);
+            gust = zigzag(frames[i].gust, frames[i-1].gust);
+        }
+        length += putVarint(&buffer[length], total);
+        length += putVarint(&buffer[length], gust);
+        if(flags & FRAME_SPREAD){
+            length += putVarint(&buffer[length], frames[i].spread);
+        }
+    }
+    if(flags & FRAME_STATUS){
+        length += putVarint(&buffer[length], status);
+        if(status & FRAME_STATUS_HELD){
+            length += putVarint(&buffer[length], frames[0].held);
+        }
+    }
+    if(flags & FRAME_SUPPLY){
+        length += putVarint(&buffer[length], supply);
+    }
+    return length;
+}
+
+/**
+ * Decodes a received frame.
+ * @param frames only valid on FRAME_OK
+ * @param count room in frames, set to the number of records on FRAME_OK
+ * @param buffer
+ * @param length bytes received
+ * @param previous last record decoded from this node, or 0
+ * @return FRAME_OK, FRAME_BAD_VERSION, FRAME_BAD_LENGTH, FRAME_NO_REFERENCE
+ * or FRAME_TOO_MANY
+ */
+uint8_t frameDecode(WindFrame* frames, uint8_t* count, const uint8_t* buffer, uint8_t length, const WindFrame* previous){
+    uint16_t total;
+    uint16_t gust;
+    uint16_t spread = 0;
+    uint16_t status = 0;
+    uint16_t supply = 0;
+    uint16_t held = 0;
+    uint8_t records = 1;
+    uint8_t used;
+    if(length < 5){
+        return FRAME_BAD_LENGTH;
+    }
+    if(buffer[0]>>FRAME_VERSION_SHIFT != FRAME_VERSION){
+        return FRAME_BAD_VERSION;
+    }
+    uint8_t flags = buffer[0] & FRAME_FLAGS_MASK;
+    uint8_t index = 3;
+    if(flags & FRAME_BATCH){
+        records = buffer[index++];
+        if(records < 2 || records > FRAME_MAX_RECORDS){
+            return FRAME_BAD_LENGTH;
+        }
+        if(records > *count){
+            return FRAME_TOO_MANY;
+        }
+    }
+    for(uint8_t i=0;i<records;i++){
+        used = getVarint(&buffer[index], length - index, &total);
+        if(!used){
+            return FRAME_BAD_LENGTH;
+        }
+        index += used;
+        used = getVarint(&buffer[index], length - index, &gust);
+        if(!used){
+            return FRAME_BAD_LENGTH;
+        }
+        index += used;
+        if(flags & FRAME_SPREAD){
+            used = getVarint(&buffer[index], length - index, &spread);
+            if(!used){
+                return FRAME_BAD_LENGTH;
+            }
+            index += used;
+        }
+        if(i > 0){
+            total = unzigzag(total, frames[i-1].total);
+            gust = unzigzag(gust, frames[i-1].gust);
+        }
+        else if(flags & FRAME_DELTA){
+            if(!previous || previous->node != buffer[1] ||
+                    (uint8_t)(previous->sequence + 1) != buffer[2]){
+                return FRAME_NO_REFERENCE;
+            }
+            total = unzigzag(total, previous->total);
+            gust = unzigzag(gust, previous->gust);
+        }
+        frames[i].node = buffer[1];
+        frames[i].sequence = buffer[2] + i;
+        frames[i].total = total;
+        frames[i].gust = gust;
+        frames[i].spread = spread;
+    }
+    if(flags & FRAME_STATUS){
+        used = getVarint(&buffer[index], length - index, &status);
+        if(!used || status > 0xFF){
+            return FRAME_BAD_LENGTH;
+        }
+        index += used;
+        if(status & FRAME_STATUS_HELD){
+            used = getVarint(&buffer[index], length - index, &held);
+            if(!used || held == 0 || held > 0xFF){
+                return FRAME_BAD_LENGTH;
+            }
+            index += used;
+            status &= ~FRAME_STATUS_HELD; //It's in held
+        }
+    }
+    if(flags & FRAME_SUPPLY){
+        used = getVarint(&buffer[index], length - index, &supply);
+        if(!used){
+            return FRAME_BAD_LENGTH;
+        }
+        index += used;
+    }
+    if(index != length){
+        return FRAME_BAD_LENGTH;
+    }
+    for(uint8_t i=0;i<records;i++){
+        frames[i].status = status;
+        frames[i].supply = supply;
+        frames[i].held = 0;
+    }
+    frames[0].held = held;
+    *count = records;
+    return FRAME_OK;
+}
@@ -0,0 +1,74 @@
+/*
+ * File:   frame.h
+ * Comments: Wind frame format, shared by the sensor (encoder) and the
+ * receiver (decoder).
+ *
+ * Byte 0 is the header: version in the top 3 bits, flags in the rest.
+ * Byte 1 is the node id, byte 2 the sequence number (wraps at 255).
+ * With FRAME_BATCH a record count (2 to FRAME_MAX_RECORDS) comes next.
+ * Then total and gust of the first record as varints, 7 bits per byte,
+ * least significant group first, top bit set when another byte follows.
+ * With FRAME_DELTA they are zigzag coded differences from the record before
+ * instead, so small changes take one byte.  Any further records are always
+ * differences from the one before them in the frame.  Records are one
+ * minute each and the sequence number is that of the first, the rest
+ * follow on.  With FRAME_SPREAD each record's total and gust are followed
+ * by the standard deviation of its 2s counts, a plain varint in 1/16
+ * counts.  It's left out when every record's is 0, as for calm minutes.
+ * The status byte follows, as a varint, only when FRAME_STATUS is set, and
+ * applies to the whole frame.  With FRAME_STATUS_HELD in it a varint
+ * follows, the number of minutes just before the first record that the
+ * sensor held back as unchanged (report.h).  The receiver can take them as
+ * repeats of the record before them, and tell them from lost ones, whose
+ * sequence numbers aren't covered.  The supply voltage in mV is last, a
+ * varint, only when FRAME_SUPPLY is set (supply.h).
+ * A minute with no wind is 5 bytes, 10 calm minutes batched are 24.
+ * A delta frame can only be decoded against the record with the previous
+ * sequence number, so the sensor sends an absolute frame at least every
+ * FRAME_ABSOLUTE_EVERY frames.
+ */
+
+#ifndef FRAME_H
+#define	FRAME_H
+
+#include <stdint.h>
+
+#define FRAME_VERSION 1
+#define FRAME_VERSION_SHIFT 5
+#define FRAME_DELTA 0x01 //Total and gust are differences from the last frame
+#define FRAME_STATUS 0x02 //Status byte present
+#define FRAME_BATCH 0x04 //Record count present
+#define FRAME_SPREAD 0x08 //Standard deviation present in each record
+#define FRAME_SUPPLY 0x10 //Supply voltage present
+#define FRAME_FLAGS_MASK 0x1F
+#define FRAME_MAX_RECORDS 10
+#define FRAME_ABSOLUTE_EVERY 10 //Frames, so a lost frame only costs the deltas up to the next one
+#define FRAME_MAX_LENGTH (4 + 9*FRAME_MAX_RECORDS + 2 + 2 + 3) //Header, node, sequence, count, 3x3 varint bytes per record, 2 status, 2 held, 3 supply
+
+//Status bits
+#define FRAME_STATUS_RESTART 0x01 //First frame since the sensor reset
+#define FRAME_STATUS_CONFIGURED 0x02 //A downlink command was accepted (downlink.h)
+#define FRAME_STATUS_HELD 0x04 //Held minute count present, set by frameEncode from held
+
+//frameDecode results
+#define FRAME_OK 0
+#define FRAME_BAD_VERSION 1
+#define FRAME_BAD_LENGTH 2 //Truncated, over long varint or trailing bytes
+#define FRAME_NO_REFERENCE 3 //Delta frame without the record before it
+#define FRAME_TOO_MANY 4 //More records than the caller has room for
+
+typedef struct {
+    uint8_t node;
+    uint8_t sequence;
+    uint16_t total; //Pulses in the minute
+    uint16_t gust; //Highest 2s count
+    uint16_t spread; //Standard deviation of the 2s counts, 1/16 counts (stats.h)
+    uint8_t status; //0 is not sent
+    uint16_t supply; //VDD in mV, 0 is not sent
+    uint8_t held; //Unchanged minutes left out before this record, first record only
+} WindFrame;
+
+uint8_t frameEncode(uint8_t*, const WindFrame*, uint8_t, const WindFrame*); //Buffer of FRAME_MAX_LENGTH, records, count, previous or 0.  Returns length.
+uint8_t frameDecode(WindFrame*, uint8_t*, const uint8_t*, uint8_t, const WindFrame*); //Records out, room in/count out, buffer, length, previous or 0.  Returns FRAME_OK or an error.
+
+#endif	/* FRAME_H */
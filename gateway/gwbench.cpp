@@ -0,0 +1,286 @@
+/*
+ * File:   gwbench.cpp
+ * Throughput of the gateway ingest.  A packet stream is made up in memory
+ * the way the sensors send it: frameEncode from the firmware, a batch of
+ * records per frame, delta coded against the last frame with an absolute
+ * one every FRAME_ABSOLUTE_EVERY, the first flagged as a restart.  Some
+ * minutes repeat the one before and, when nothing is waiting to go, are
+ * held back as the sensors do (report.h), for the ingest to fill in.  Some
+ * packets are lost and some heard twice.
+ * The stream is first decoded on one thread against the records it was
+ * made from, which must all match, then timed on one thread and through
+ * ParallelIngest at 1, 2, 4.. threads.  Filled in minutes must be ones
+ * that were held back, and held back ones must arrive as filled in.  Records go to CSV on /dev/null so
+ * the formatting is part of the cost.
+ * Usage: gwbench [-n nodes] [-m minutes] [-b batch] [-l loss %] [-d dup %]
+ *                [-r repeat %] [-j threads] [-w packets]
+ *   -w  also saves the stream for windgw
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "packet.hpp"
+#include "parallel.hpp"
+extern "C" {
+#include "../frame.h"
+}
+
+#define DEFAULT_NODES 250
+#define DEFAULT_MINUTES (7*24*60)
+#define DEFAULT_LOSS 1.0
+#define DEFAULT_DUPLICATES 2.0
+#define DEFAULT_REPEATS 10.0
+#define HELD_MAX 14 //REPORT_HEARTBEAT_MINUTES - 1
+
+//Repeatable, so a run can be reproduced
+static uint32_t lcg = 12345;
+static uint32_t random32(){
+    lcg = lcg*1664525UL + 1013904223UL;
+    return lcg;
+}
+
+static double percent(){
+    return (random32()>>8)/167772.16;
+}
+
+typedef struct {
+    uint16_t nodes;
+    uint32_t minutes;
+    std::vector<std::vector<WindFrame>> sent; //By node id then minute
+    std::vector<std::vector<uint8_t>> held; //1 for minutes held back, same index
+    std::vector<uint8_t> stream;
+    uint64_t frames;
+    uint64_t heldMinutes;
+} Generated;
+
+//One sensor's minute, with a bit of wind now and then
+static WindFrame makeRecord(uint8_t node, uint32_t minute){
+    WindFrame record;
+    uint32_t noise = random32();
+    record.node = node;
+    record.sequence = minute;
+    record.total = (noise & 0x3) ? noise>>8 & 0x3FF : 0;
+    record.gust = record.total ? (record.total>>4) + (noise>>20 & 0xF) : 0;
+    record.spread = record.total ? noise>>24 : 0;
+    record.status = minute == 0 ? FRAME_STATUS_RESTART : 0;
+    record.supply = minute % 60 == 0 ? 2400 + minute/60 % 600 : 0; //Hourly, as supply.h
+    record.held = 0;
+    return record;
+}
+
+static void generate(Generated& g, uint8_t batch, double loss, double duplicates, double repeats){
+    std::vector<uint8_t> sinceAbsolute(g.nodes + 1);
+    std::vector<uint32_t> unsent(g.nodes + 1); //First minute not yet sent
+    std::vector<WindFrame> last(g.nodes + 1);
+    std::vector<uint8_t> held(g.nodes + 1); //Minutes held back just before unsent
+    g.sent.assign(g.nodes + 1, std::vector<WindFrame>());
+    g.held.assign(g.nodes + 1, std::vector<uint8_t>());
+    g.frames = 0;
+    g.heldMinutes = 0;
+    for(uint32_t minute=0;minute<g.minutes;minute++){
+        for(uint16_t node=1;node<=g.nodes;node++){
+            WindFrame record = makeRecord(node, minute);
+            uint8_t hold = 0;
+            if(minute > 0 && percent() < repeats){
+                const WindFrame& before = g.sent[node][minute - 1];
+                record.total = before.total;
+                record.gust = before.gust;
+                record.spread = before.spread;
+                //Held back, as reportTask would, only with nothing waiting
+                hold = unsent[node] == minute && !record.status && !record.supply &&
+                        held[node] < HELD_MAX && minute != g.minutes - 1;
+            }
+            g.sent[node].push_back(record);
+            g.held[node].push_back(hold);
+            if(hold){
+                unsent[node] = minute + 1;
+                held[node]++;
+                g.heldMinutes++;
+                continue;
+            }
+            if((minute + node) % batch != batch - 1u && minute != g.minutes - 1){
+                continue; //Nodes send in different minutes
+            }
+            uint8_t count = minute + 1 - unsent[node];
+            uint8_t buffer[FRAME_MAX_LENGTH];
+            WindFrame& first = g.sent[node][unsent[node]];
+            first.held = held[node];
+            uint8_t length = frameEncode(buffer, &first, count,
+                                         sinceAbsolute[node] && !held[node] ? &last[node] : 0);
+            first.held = 0;
+            held[node] = 0;
+            unsent[node] = minute + 1;
+            last[node] = g.sent[node][minute];
+            if(++sinceAbsolute[node] >= FRAME_ABSOLUTE_EVERY){
+                sinceAbsolute[node] = 0;
+            }
+            if(percent() < loss){
+                continue;
+            }
+            g.stream.push_back(length);
+            g.stream.insert(g.stream.end(), buffer, buffer + length);
+            g.frames++;
+            if(percent() < duplicates){
+                g.stream.push_back(length);
+                g.stream.insert(g.stream.end(), buffer, buffer + length);
+                g.frames++;
+            }
+        }
+    }
+}
+
+//Checks every record the ingest passes on against what was sent
+class CheckSink : public RecordSink {
+public:
+    explicit CheckSink(const Generated& g) : g(g), lastMinute(g.nodes + 1, 0), filled(0), errors(0){
+    }
+    void write(const WindFrame* records, size_t count){
+        for(size_t i=0;i<count;i++){
+            const WindFrame& r = records[i];
+            if(r.node < 1 || r.node > g.nodes){
+                errors++;
+                continue;
+            }
+            //Records arrive near enough in order to place them from the last one
+            int64_t minute = (int64_t)lastMinute[r.node] + (int8_t)(r.sequence - (uint8_t)lastMinute[r.node]);
+            if(minute < 0 || minute >= (int64_t)g.minutes){
+                errors++;
+                continue;
+            }
+            const WindFrame& s = g.sent[r.node][minute];
+            uint8_t isFilled = (r.status & FRAME_STATUS_HELD) != 0;
+            if(s.total != r.total || s.gust != r.gust || s.spread != r.spread ||
+                    isFilled != g.held[r.node][minute]){
+                errors++;
+            }
+            filled += isFilled;
+            lastMinute[r.node] = minute;
+        }
+    }
+    const Generated& g;
+    std::vector<uint32_t> lastMinute;
+    uint64_t filled;
+    uint64_t errors;
+};
+
+static void decodeAll(const Generated& g, void (*each)(void*, const uint8_t*, uint8_t), void* context){
+    const std::vector<uint8_t>& s = g.stream;
+    for(size_t i=0;i<s.size();i += s[i] + 1){
+        each(context, &s[i + 1], s[i]);
+    }
+}
+
+static void toIngest(void* ingest, const uint8_t* data, uint8_t length){
+    ((Ingest*)ingest)->packet(data, length);
+}
+
+static void toParallel(void* ingest, const uint8_t* data, uint8_t length){
+    ((ParallelIngest*)ingest)->packet(data, length);
+}
+
+static double seconds(std::chrono::steady_clock::time_point since){
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+}
+
+static void usage(){
+    fprintf(stderr, "usage: gwbench [-n nodes] [-m minutes] [-b batch] [-l loss %%] [-d dup %%]"
+            " [-r repeat %%] [-j threads] [-w packets]\n");
+    exit(1);
+}
+
+int main(int argc, char **argv){
+    Generated g;
+    g.nodes = DEFAULT_NODES;
+    g.minutes = DEFAULT_MINUTES;
+    int batch = 1;
+    double loss = DEFAULT_LOSS;
+    double duplicates = DEFAULT_DUPLICATES;
+    double repeats = DEFAULT_REPEATS;
+    unsigned maxThreads = std::thread::hardware_concurrency();
+    const char* saveName = 0;
+    for(int i=1;i<argc;i++){
+        if(argv[i][0] != '-' || i + 1 >= argc){
+            usage();
+        }
+        const char* value = argv[++i];
+        switch(argv[i-1][1]){
+            case 'n': g.nodes = atoi(value); break;
+            case 'm': g.minutes = atol(value); break;
+            case 'b': batch = atoi(value); break;
+            case 'l': loss = atof(value); break;
+            case 'd': duplicates = atof(value); break;
+            case 'r': repeats = atof(value); break;
+            case 'j': maxThreads = atoi(value); break;
+            case 'w': saveName = value; break;
+            default: usage();
+        }
+    }
+    if(g.nodes < 1 || g.nodes > INGEST_NODES - 1 || g.minutes < 1 ||
+            batch < 1 || batch > FRAME_MAX_RECORDS){
+        usage();
+    }
+    if(maxThreads < 1){
+        maxThreads = 1;
+    }
+
+    generate(g, batch, loss, duplicates, repeats);
+    printf("%u nodes, %lu minutes, %d a frame, %.1f%% lost, %.1f%% heard twice: %llu frames, %zu bytes,"
+           " %llu minutes held back\n",
+           g.nodes, (unsigned long)g.minutes, batch, loss, duplicates,
+           (unsigned long long)g.frames, g.stream.size(), (unsigned long long)g.heldMinutes);
+    if(saveName){
+        FILE* file = fopen(saveName, "wb");
+        if(!file || fwrite(g.stream.data(), 1, g.stream.size(), file) != g.stream.size() || fclose(file)){
+            perror(saveName);
+            return 1;
+        }
+    }
+
+    CheckSink check(g);
+    Ingest checked(check);
+    decodeAll(g, toIngest, &checked);
+    IngestCounts c = checked.counts();
+    printf("Check: %llu records, %llu filled in, %llu duplicates, %llu without reference, %llu lost, %llu wrong\n",
+           (unsigned long long)c.records, (unsigned long long)c.filled, (unsigned long long)c.duplicates,
+           (unsigned long long)c.noReference, (unsigned long long)c.lost,
+           (unsigned long long)check.errors);
+    if(check.errors || c.badFrames || c.conflicts || check.filled != c.filled ||
+            (g.heldMinutes && !c.filled)){
+        printf("FAIL\n");
+        return 1;
+    }
+
+    FILE* null = fopen("/dev/null", "w");
+    if(!null){
+        perror("/dev/null");
+        return 1;
+    }
+    printf("%-12s %12s %12s %10s\n", "ingest", "frames/s", "records/s", "speed up");
+    double single;
+    {
+        CsvSink sink(null);
+        Ingest ingest(sink);
+        auto start = std::chrono::steady_clock::now();
+        decodeAll(g, toIngest, &ingest);
+        ingest.flush();
+        double time = seconds(start);
+        single = g.frames/time;
+        printf("%-12s %12.0f %12.0f %10.2f\n", "1 thread", single, ingest.counts().records/time, 1.0);
+    }
+    for(unsigned threads=1;threads<=maxThreads;threads *= 2){
+        ParallelIngest ingest(threads, null);
+        auto start = std::chrono::steady_clock::now();
+        decodeAll(g, toParallel, &ingest);
+        ingest.finish();
+        double time = seconds(start);
+        char name[20];
+        snprintf(name, sizeof(name), "parallel %u", threads);
+        printf("%-12s %12.0f %12.0f %10.2f\n", name, g.frames/time,
+               ingest.counts().records/time, g.frames/time/single);
+    }
+    fclose(null);
+    return 0;
+}
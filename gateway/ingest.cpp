@@ -0,0 +1,220 @@
+/*
+ * File:   ingest.cpp
+ * Per node decoding, duplicate and gap tracking, see ingest.hpp.
+ * The window is the INGEST_WINDOW sequence numbers up to and including a
+ * node's head.  Entries outside it are always clear, so a sequence number
+ * coming round again finds its slot empty.
+ */
+#include <cstring>
+#include "ingest.hpp"
+
+Ingest::Ingest(RecordSink& sink) : sink(sink){
+    memset(&totals, 0, sizeof(totals));
+}
+
+static uint8_t sameRecord(const WindFrame& a, const WindFrame& b){
+    return a.total == b.total && a.gust == b.gust && a.spread == b.spread;
+}
+
+//Forgets the window, anything still missing is lost
+void Ingest::clear(Node& node, uint8_t sequence){
+    node.counts.lost += node.missing.count();
+    node.held.reset();
+    node.missing.reset();
+    node.head = sequence;
+    node.started = 1;
+}
+
+/**
+ * Moves the head on, expiring the sequence numbers that leave the window
+ * and marking the ones jumped over as missing.
+ * @param node
+ * @param sequence new head, 1 to INGEST_WINDOW-1 ahead
+ */
+void Ingest::advance(Node& node, uint8_t sequence){
+    uint8_t steps = sequence - node.head;
+    for(uint8_t k=1;k<=steps;k++){
+        uint8_t entering = node.head + k;
+        uint8_t leaving = entering - INGEST_WINDOW;
+        if(node.missing[leaving]){
+            node.missing.reset(leaving);
+            node.counts.lost++;
+        }
+        node.held.reset(leaving);
+        if(k < steps){
+            node.missing.set(entering);
+            node.counts.skipped++;
+        }
+    }
+    node.head = sequence;
+}
+
+/**
+ * Takes a decoded record into the window.
+ * @return 1 if it's new and goes to the sink
+ */
+uint8_t Ingest::accept(Node& node, const WindFrame& record, uint8_t status){
+    uint8_t sequence = record.sequence;
+    int8_t ahead = sequence - node.head;
+    if(!node.started){
+        clear(node, sequence);
+    }
+    else if(ahead == -INGEST_WINDOW){
+        clear(node, sequence); //Can't tell old from new, start again here
+        node.counts.resyncs++;
+    }
+    else if(ahead > 0){
+        advance(node, sequence);
+    }
+    else if(node.held[sequence]){
+        if(sameRecord(node.records[sequence], record) ||
+                node.records[sequence].status == FRAME_STATUS_HELD){
+            node.counts.duplicates++;
+        }
+        else{
+            node.counts.conflicts++;
+        }
+        return 0;
+    }
+    else if(node.missing[sequence]){
+        node.missing.reset(sequence);
+        node.counts.recovered++;
+    }
+    node.records[sequence] = record;
+    node.records[sequence].status = status;
+    node.held.set(sequence);
+    node.counts.records++;
+    return 1;
+}
+
+/**
+ * Fills in the minutes held back before a frame's first record from the
+ * record before them.  Ones already held, from the same frame heard
+ * before, are left alone.
+ * @param node
+ * @param first record with the held count
+ * @param out the new records are added here
+ * @return number added
+ */
+uint8_t Ingest::fill(Node& node, const WindFrame& first, WindFrame* out){
+    uint8_t before = first.sequence - first.held - 1;
+    uint8_t added = 0;
+    if(!node.started || !node.held[before]){
+        return 0; //Lost too, they stay skipped
+    }
+    WindFrame repeat = node.records[before];
+    repeat.supply = 0;
+    repeat.held = 0;
+    for(unsigned k=1;k<=first.held;k++){
+        repeat.sequence = before + k;
+        if(!node.held[repeat.sequence] && accept(node, repeat, FRAME_STATUS_HELD)){
+            out[added++] = node.records[repeat.sequence];
+            node.counts.filled++;
+        }
+    }
+    return added;
+}
+
+/**
+ * Decodes one received frame and sends the records that are new to the sink.
+ * @param data
+ * @param length
+ * @return FRAME_OK, or the frameDecode error for a frame that was dropped
+ */
+uint8_t Ingest::packet(const uint8_t* data, uint8_t length){
+    WindFrame records[FRAME_MAX_RECORDS];
+    WindFrame accepted[255 + FRAME_MAX_RECORDS]; //Held back minutes and the frame's records
+    uint8_t count = FRAME_MAX_RECORDS;
+    if(length < 3){
+        totals.frames++;
+        totals.badFrames++; //No node id to put it against
+        return FRAME_BAD_LENGTH;
+    }
+    std::unique_ptr<Node>& slot = nodes[data[1]];
+    if(!slot){
+        slot.reset(new Node());
+    }
+    Node& node = *slot;
+    node.counts.frames++;
+    uint8_t before = data[2] - 1;
+    const WindFrame* previous = node.started && node.held[before] ? &node.records[before] : 0;
+    uint8_t result = frameDecode(records, &count, data, length, previous);
+    if(result == FRAME_NO_REFERENCE){
+        node.counts.noReference++;
+        return result;
+    }
+    if(result == FRAME_OK && records[0].held + count >= INGEST_WINDOW){
+        result = FRAME_BAD_LENGTH; //Reaches back out of the window, the sensor holds at most 100
+    }
+    if(result != FRAME_OK){
+        node.counts.badFrames++;
+        return result;
+    }
+    if(records[0].supply){
+        node.supply = records[0].supply;
+    }
+    uint8_t first = records[0].sequence;
+    if((records[0].status & FRAME_STATUS_RESTART) && node.started &&
+            (int8_t)(first - node.head) <= 0 &&
+            !(node.held[first] && sameRecord(node.records[first], records[0]))){
+        clear(node, first); //Sensor's log was blank, its numbers start again
+        node.counts.restarts++;
+    }
+    unsigned fresh = 0;
+    if(records[0].held){
+        fresh = fill(node, records[0], accepted);
+    }
+    for(uint8_t i=0;i<count;i++){
+        if(accept(node, records[i], records[0].status)){
+            accepted[fresh++] = node.records[records[i].sequence];
+        }
+    }
+    if(fresh){
+        sink.write(accepted, fresh);
+    }
+    return FRAME_OK;
+}
+
+void Ingest::flush(){
+    sink.flush();
+}
+
+void Ingest::add(IngestCounts& sum, const IngestCounts& counts){
+    sum.frames += counts.frames;
+    sum.badFrames += counts.badFrames;
+    sum.noReference += counts.noReference;
+    sum.records += counts.records;
+    sum.duplicates += counts.duplicates;
+    sum.conflicts += counts.conflicts;
+    sum.skipped += counts.skipped;
+    sum.recovered += counts.recovered;
+    sum.lost += counts.lost;
+    sum.restarts += counts.restarts;
+    sum.resyncs += counts.resyncs;
+    sum.filled += counts.filled;
+}
+
+/**
+ * Totals over all nodes, including frames too short to have a node id.
+ */
+IngestCounts Ingest::counts() const{
+    IngestCounts sum = totals;
+    for(int i=0;i<INGEST_NODES;i++){
+        if(nodes[i]){
+            add(sum, nodes[i]->counts);
+        }
+    }
+    return sum;
+}
+
+const IngestCounts* Ingest::node(uint8_t id) const{
+    return nodes[id] ? &nodes[id]->counts : 0;
+}
+
+uint8_t Ingest::outstanding(uint8_t id) const{
+    return nodes[id] ? nodes[id]->missing.count() : 0;
+}
+
+uint16_t Ingest::supply(uint8_t id) const{
+    return nodes[id] ? nodes[id]->supply : 0;
+}
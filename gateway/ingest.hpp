@@ -0,0 +1,88 @@
+/*
+ * File:   ingest.hpp
+ * Comments: Receiver side of the wind frame format, for a gateway with
+ * many sensors behind it.  Frames are decoded by frameDecode from the
+ * firmware's own frame.c, so the encoder and decoder share one definition.
+ * For each node the records for the last INGEST_WINDOW sequence numbers
+ * are kept.  They give:
+ *  - the reference for a delta frame, the record one before its first
+ *  - duplicates, a record already held with the same total, gust and
+ *    spread.  The sensor sends records again after a lost TxDone, and
+ *    more than one concentrator may hear a packet.  Status isn't compared
+ *    as it's shared by the whole frame.
+ *  - gaps, sequence numbers skipped when a node jumps ahead.  One that
+ *    turns up later (a backfill, downlink.h) counts as recovered, one that
+ *    drops out of the window without turning up as lost.
+ * The window is bigger than the sensor's EEPROM log (EELOG_SLOTS), so any
+ * record a sensor can send again is still tracked.  A node that comes
+ * back after more than the window is picked up again from where it is.
+ * A different record for a sequence number already held means the sensor
+ * started from a blank log.  With FRAME_STATUS_RESTART the node is
+ * cleared and the frame taken, without it the record is counted as a
+ * conflict and dropped.
+ * Accepted records go to the sink.  An Ingest is for one thread.
+ * Minutes a sensor held back as unchanged (FRAME_STATUS_HELD) are filled
+ * in as repeats of the record before them, with FRAME_STATUS_HELD as their
+ * status, when that record is held.  Otherwise they're left as skipped.
+ * The real record for a filled in minute, from a backfill, counts as a
+ * duplicate as the sink already has the minute.
+ * The last supply voltage (FRAME_SUPPLY) each node sent is kept, from any
+ * frame that decodes, so a failing battery shows up even in duplicates.
+ */
+
+#ifndef INGEST_HPP
+#define	INGEST_HPP
+
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include "sink.hpp"
+
+#define INGEST_NODES 256 //Node ids are 8 bits
+#define INGEST_WINDOW 128 //Sequence numbers remembered, half their range
+
+typedef struct {
+    uint64_t frames; //Packets given to packet()
+    uint64_t badFrames; //FRAME_BAD_VERSION, FRAME_BAD_LENGTH or FRAME_TOO_MANY, or held minutes reaching out of the window
+    uint64_t noReference; //Delta frames without the record before them
+    uint64_t records; //Accepted and sent to the sink
+    uint64_t duplicates;
+    uint64_t conflicts; //Different record for a sequence number already held
+    uint64_t skipped; //Sequence numbers jumped over
+    uint64_t recovered; //Skipped ones that turned up later
+    uint64_t lost; //Skipped ones that left the window
+    uint64_t restarts; //Nodes cleared by FRAME_STATUS_RESTART
+    uint64_t resyncs; //Nodes picked up again after too long away
+    uint64_t filled; //Held back minutes filled in, included in records
+} IngestCounts;
+
+class Ingest {
+public:
+    explicit Ingest(RecordSink&);
+    uint8_t packet(const uint8_t*, uint8_t); //Frame, length.  FRAME_OK or the frameDecode error.
+    void flush(); //Writes out what the sink is holding
+    IngestCounts counts() const; //Over all nodes
+    const IngestCounts* node(uint8_t) const; //0 if nothing has been heard from it
+    uint8_t outstanding(uint8_t) const; //Sequence numbers skipped and not yet recovered or lost
+    uint16_t supply(uint8_t) const; //Last supply voltage the node sent, mV, 0 if none
+    static void add(IngestCounts&, const IngestCounts&);
+private:
+    struct Node {
+        WindFrame records[256]; //By sequence number
+        std::bitset<256> held; //records[] entry is valid
+        std::bitset<256> missing; //Skipped, not yet received
+        uint8_t head; //Newest sequence number
+        uint8_t started;
+        uint16_t supply; //mV
+        IngestCounts counts;
+    };
+    void clear(Node&, uint8_t);
+    uint8_t accept(Node&, const WindFrame&, uint8_t);
+    uint8_t fill(Node&, const WindFrame&, WindFrame*);
+    void advance(Node&, uint8_t);
+    RecordSink& sink;
+    std::unique_ptr<Node> nodes[INGEST_NODES];
+    IngestCounts totals;
+};
+
+#endif	/* INGEST_HPP */
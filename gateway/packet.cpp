@@ -0,0 +1,53 @@
+/*
+ * File:   packet.cpp
+ * Raw packet stream reading and writing, see packet.hpp.
+ * Packets are handed out in place in a large read buffer, which is only
+ * topped up when less than the largest packet is left in it.
+ */
+#include <cstring>
+#include "packet.hpp"
+
+PacketReader::PacketReader(FILE* file) : file(file), start(0), end(0), eof(0), cut(0){
+}
+
+/**
+ * @param data set to the packet, valid until the next call
+ * @return length, 0 when the stream has ended
+ */
+uint8_t PacketReader::next(const uint8_t** data){
+    for(;;){
+        if(end - start < 256 && !eof){
+            memmove(buffer, &buffer[start], end - start);
+            end -= start;
+            start = 0;
+            while(end < sizeof(buffer) && !eof){
+                size_t got = fread(&buffer[end], 1, sizeof(buffer) - end, file);
+                end += got;
+                eof = got == 0;
+            }
+        }
+        if(start == end){
+            return 0;
+        }
+        uint8_t length = buffer[start];
+        if(end - start < (size_t)length + 1){
+            cut += end - start;
+            start = end;
+            return 0;
+        }
+        start += length + 1;
+        if(length){
+            *data = &buffer[start - length];
+            return length;
+        }
+    }
+}
+
+uint64_t PacketReader::truncated() const{
+    return cut;
+}
+
+void packetWrite(FILE* file, const uint8_t* data, uint8_t length){
+    fputc(length, file);
+    fwrite(data, 1, length, file);
+}
@@ -0,0 +1,33 @@
+/*
+ * File:   packet.hpp
+ * Comments: Raw packet stream, standing in for the concentrator: each
+ * packet as received is one length byte then that many bytes of frame.
+ * A zero length is skipped.  A packet cut short at the end of the stream
+ * is counted and dropped.
+ */
+
+#ifndef PACKET_HPP
+#define	PACKET_HPP
+
+#include <cstdint>
+#include <cstdio>
+
+#define PACKET_READ_BYTES 65536
+
+class PacketReader {
+public:
+    explicit PacketReader(FILE*);
+    uint8_t next(const uint8_t**); //Length of the next packet and where it is, 0 at the end
+    uint64_t truncated() const; //Bytes of a packet cut short by the end of the stream
+private:
+    FILE* file;
+    uint8_t buffer[PACKET_READ_BYTES];
+    size_t start; //Next unread byte
+    size_t end;
+    uint8_t eof;
+    uint64_t cut;
+};
+
+void packetWrite(FILE*, const uint8_t*, uint8_t); //Adds a packet to a stream
+
+#endif	/* PACKET_HPP */
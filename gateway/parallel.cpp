@@ -0,0 +1,102 @@
+/*
+ * File:   parallel.cpp
+ * Ingest sharded over threads by node id, see parallel.hpp.
+ */
+#include "parallel.hpp"
+
+ParallelIngest::ParallelIngest(unsigned threads, FILE* file) : finished(0){
+    for(unsigned i=0;i<threads;i++){
+        std::unique_ptr<Worker> worker(new Worker());
+        worker->done = 0;
+        worker->sink.reset(new CsvSink(file, &output));
+        worker->ingest.reset(new Ingest(*worker->sink));
+        worker->filling.reserve(PARALLEL_BATCH_BYTES + 256);
+        workers.push_back(std::move(worker));
+    }
+    for(unsigned i=0;i<threads;i++){
+        workers[i]->thread = std::thread(run, workers[i].get());
+    }
+}
+
+ParallelIngest::~ParallelIngest(){
+    finish();
+}
+
+//Queues the reader's batch, waiting if the worker is too far behind
+void ParallelIngest::send(Worker& worker){
+    std::unique_lock<std::mutex> guard(worker.lock);
+    while(worker.queue.size() >= PARALLEL_QUEUE_DEPTH){
+        worker.room.wait(guard);
+    }
+    worker.queue.push_back(std::move(worker.filling));
+    worker.filling = std::vector<uint8_t>();
+    worker.filling.reserve(PARALLEL_BATCH_BYTES + 256);
+    worker.ready.notify_one();
+}
+
+/**
+ * Hands a packet to the worker for its node.  Too short to have a node
+ * id goes to the first, which counts it as a bad frame.
+ * @param data
+ * @param length
+ */
+void ParallelIngest::packet(const uint8_t* data, uint8_t length){
+    Worker& worker = *workers[length >= 2 ? data[1] % workers.size() : 0];
+    worker.filling.push_back(length);
+    worker.filling.insert(worker.filling.end(), data, data + length);
+    if(worker.filling.size() >= PARALLEL_BATCH_BYTES){
+        send(worker);
+    }
+}
+
+void ParallelIngest::run(Worker* worker){
+    for(;;){
+        std::vector<uint8_t> batch;
+        {
+            std::unique_lock<std::mutex> guard(worker->lock);
+            while(worker->queue.empty() && !worker->done){
+                worker->ready.wait(guard);
+            }
+            if(worker->queue.empty()){
+                break; //Done and drained
+            }
+            batch = std::move(worker->queue.front());
+            worker->queue.pop_front();
+            worker->room.notify_one();
+        }
+        for(size_t i=0;i<batch.size();i += batch[i] + 1){
+            worker->ingest->packet(&batch[i + 1], batch[i]);
+        }
+    }
+    worker->ingest->flush();
+}
+
+void ParallelIngest::finish(){
+    if(finished){
+        return;
+    }
+    finished = 1;
+    for(auto& worker : workers){
+        if(!worker->filling.empty()){
+            send(*worker);
+        }
+        std::lock_guard<std::mutex> guard(worker->lock);
+        worker->done = 1;
+        worker->ready.notify_one();
+    }
+    for(auto& worker : workers){
+        worker->thread.join();
+    }
+}
+
+IngestCounts ParallelIngest::counts() const{
+    IngestCounts sum = IngestCounts();
+    for(auto& worker : workers){
+        Ingest::add(sum, worker->ingest->counts());
+    }
+    return sum;
+}
+
+const Ingest& ParallelIngest::shard(uint8_t node) const{
+    return *workers[node % workers.size()]->ingest;
+}
@@ -0,0 +1,54 @@
+/*
+ * File:   parallel.hpp
+ * Comments: Spreads the ingest over several threads by node id.  Each
+ * worker has its own Ingest for the nodes id % threads == its number, so
+ * a node's frames stay in order and no node state is shared.  Packets are
+ * passed over in batches of PARALLEL_BATCH_BYTES, in the packet.hpp
+ * stream format, through a queue PARALLEL_QUEUE_DEPTH batches deep that
+ * holds the reader up when a worker falls behind.
+ * The workers' CSV sinks share the output file and write whole batches,
+ * so records come out grouped by worker rather than in arrival order.
+ */
+
+#ifndef PARALLEL_HPP
+#define	PARALLEL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "ingest.hpp"
+
+#define PARALLEL_BATCH_BYTES 16384
+#define PARALLEL_QUEUE_DEPTH 8
+
+class ParallelIngest {
+public:
+    ParallelIngest(unsigned, FILE*); //Threads, at least 1, and where the CSV goes
+    ~ParallelIngest();
+    void packet(const uint8_t*, uint8_t); //Frame, length
+    void finish(); //Waits for the workers to empty their queues and flushes
+    IngestCounts counts() const; //Once finished
+    const Ingest& shard(uint8_t) const; //Ingest that has a node, once finished
+private:
+    struct Worker {
+        std::thread thread;
+        std::mutex lock;
+        std::condition_variable ready; //Batch queued or finishing
+        std::condition_variable room; //Batch taken
+        std::deque<std::vector<uint8_t>> queue;
+        std::vector<uint8_t> filling; //Reader's side, not yet queued
+        uint8_t done;
+        std::unique_ptr<CsvSink> sink;
+        std::unique_ptr<Ingest> ingest;
+    };
+    void send(Worker&);
+    static void run(Worker*);
+    std::mutex output;
+    std::vector<std::unique_ptr<Worker>> workers;
+    uint8_t finished;
+};
+
+#endif	/* PARALLEL_HPP */
@@ -0,0 +1,79 @@
+/*
+ * File:   sink.cpp
+ * Batched CSV output of decoded records, see sink.hpp.
+ */
+#include "sink.hpp"
+
+CsvSink::CsvSink(FILE* file, std::mutex* lock, size_t batchBytes)
+        : file(file), lock(lock), batchBytes(batchBytes){
+    buffer.reserve(batchBytes + 64);
+}
+
+CsvSink::~CsvSink(){
+    flush();
+}
+
+//Unsigned decimal, quicker than snprintf for the millions of fields
+static char* putNumber(char* out, unsigned value){
+    char digits[5];
+    int length = 0;
+    do{
+        digits[length++] = '0' + value % 10;
+        value /= 10;
+    } while(value);
+    while(length){
+        *out++ = digits[--length];
+    }
+    return out;
+}
+
+/**
+ * Adds one line per record, node,sequence,total,gust,spread,status,supply,
+ * and writes the batch when it's full.  supply is empty when the frame
+ * didn't carry one.
+ * @param records
+ * @param count
+ */
+void CsvSink::write(const WindFrame* records, size_t count){
+    for(size_t i=0;i<count;i++){
+        char line[48];
+        char* end = putNumber(line, records[i].node);
+        *end++ = ',';
+        end = putNumber(end, records[i].sequence);
+        *end++ = ',';
+        end = putNumber(end, records[i].total);
+        *end++ = ',';
+        end = putNumber(end, records[i].gust);
+        *end++ = ',';
+        end = putNumber(end, records[i].spread);
+        *end++ = ',';
+        end = putNumber(end, records[i].status);
+        *end++ = ',';
+        if(records[i].supply){
+            end = putNumber(end, records[i].supply);
+        }
+        *end++ = '\n';
+        buffer.append(line, end - line);
+    }
+    if(buffer.size() >= batchBytes){
+        flush();
+    }
+}
+
+void CsvSink::flush(){
+    if(buffer.empty()){
+        return;
+    }
+    if(lock){
+        std::lock_guard<std::mutex> guard(*lock);
+        fwrite(buffer.data(), 1, buffer.size(), file);
+    }
+    else{
+        fwrite(buffer.data(), 1, buffer.size(), file);
+    }
+    buffer.clear();
+}
+
+const char* CsvSink::header(){
+    return "node,sequence,total,gust,spread,status,supply\n";
+}
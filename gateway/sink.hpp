@@ -0,0 +1,43 @@
+/*
+ * File:   sink.hpp
+ * Comments: Where the gateway puts decoded records.  CsvSink formats them
+ * into a buffer and writes it out in one go once it holds batchBytes, so
+ * the file sees a few large writes rather than one per record.  Several
+ * sinks can share a file and a mutex: a batch always goes out whole, so
+ * lines from different threads never interleave.
+ */
+
+#ifndef SINK_HPP
+#define	SINK_HPP
+
+#include <cstdio>
+#include <mutex>
+#include <string>
+extern "C" {
+#include "../frame.h"
+}
+
+#define SINK_BATCH_BYTES 65536
+
+class RecordSink {
+public:
+    virtual ~RecordSink() {}
+    virtual void write(const WindFrame*, size_t) = 0; //Records, count
+    virtual void flush() {}
+};
+
+class CsvSink : public RecordSink {
+public:
+    CsvSink(FILE*, std::mutex* = 0, size_t = SINK_BATCH_BYTES); //File, lock shared with other sinks or 0, batch size
+    ~CsvSink();
+    void write(const WindFrame*, size_t);
+    void flush();
+    static const char* header(); //Column names, one line
+private:
+    FILE* file;
+    std::mutex* lock;
+    size_t batchBytes;
+    std::string buffer;
+};
+
+#endif	/* SINK_HPP */
@@ -0,0 +1,103 @@
+/*
+ * File:   windgw.cpp
+ * Gateway ingest from a raw packet stream (packet.hpp) to CSV.  Each
+ * frame is decoded, duplicates dropped and gaps tracked per node
+ * (ingest.hpp), and the new records written in batches.  A summary and a
+ * line per node go to stderr at the end.
+ * Usage: windgw [-j threads] [-o csv] [-q] [packets]
+ *   -j  spreads the nodes over that many threads (parallel.hpp)
+ *   -q  leaves out the per node lines
+ * Packets are read from stdin without a file, CSV goes to stdout without -o.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "packet.hpp"
+#include "parallel.hpp"
+
+static void usage(){
+    fprintf(stderr, "usage: windgw [-j threads] [-o csv] [-q] [packets]\n");
+    exit(1);
+}
+
+static void summary(const IngestCounts& c, uint64_t truncated){
+    fprintf(stderr, "%llu frames, %llu records, %llu duplicates, %llu bad, %llu without reference,"
+            " %llu truncated bytes\n",
+            (unsigned long long)c.frames, (unsigned long long)c.records,
+            (unsigned long long)c.duplicates, (unsigned long long)c.badFrames,
+            (unsigned long long)c.noReference, (unsigned long long)truncated);
+    fprintf(stderr, "%llu skipped, %llu recovered, %llu lost, %llu conflicts, %llu restarts, %llu resyncs,"
+            " %llu filled\n",
+            (unsigned long long)c.skipped, (unsigned long long)c.recovered,
+            (unsigned long long)c.lost, (unsigned long long)c.conflicts,
+            (unsigned long long)c.restarts, (unsigned long long)c.resyncs,
+            (unsigned long long)c.filled);
+}
+
+static void nodeLines(const ParallelIngest& ingest){
+    fprintf(stderr, "%4s %10s %10s %8s %8s %8s %8s %8s %6s %6s\n", "node", "frames", "records",
+            "dups", "skipped", "recovered", "lost", "waiting", "noref", "mV");
+    for(int id=0;id<INGEST_NODES;id++){
+        const Ingest& shard = ingest.shard(id);
+        const IngestCounts* c = shard.node(id);
+        if(c){
+            fprintf(stderr, "%4d %10llu %10llu %8llu %8llu %8llu %8llu %8u %6llu %6u\n", id,
+                    (unsigned long long)c->frames, (unsigned long long)c->records,
+                    (unsigned long long)c->duplicates, (unsigned long long)c->skipped,
+                    (unsigned long long)c->recovered, (unsigned long long)c->lost,
+                    shard.outstanding(id), (unsigned long long)c->noReference, shard.supply(id));
+        }
+    }
+}
+
+int main(int argc, char **argv){
+    unsigned threads = 1;
+    const char* outName = 0;
+    int quiet = 0;
+    int i = 1;
+    for(;i<argc && argv[i][0] == '-' && argv[i][1] != 0;i++){
+        if(strcmp(argv[i], "-q") == 0){
+            quiet = 1;
+        }
+        else if(strcmp(argv[i], "-j") == 0 && i + 1 < argc){
+            threads = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "-o") == 0 && i + 1 < argc){
+            outName = argv[++i];
+        }
+        else{
+            usage();
+        }
+    }
+    if(threads < 1 || threads > INGEST_NODES || i + 1 < argc){
+        usage();
+    }
+    FILE* in = stdin;
+    FILE* out = stdout;
+    if(i < argc && !(in = fopen(argv[i], "rb"))){
+        perror(argv[i]);
+        return 1;
+    }
+    if(outName && !(out = fopen(outName, "w"))){
+        perror(outName);
+        return 1;
+    }
+    fputs(CsvSink::header(), out);
+    PacketReader reader(in);
+    ParallelIngest ingest(threads, out);
+    const uint8_t* data;
+    uint8_t length;
+    while((length = reader.next(&data)) != 0){
+        ingest.packet(data, length);
+    }
+    ingest.finish();
+    summary(ingest.counts(), reader.truncated());
+    if(!quiet){
+        nodeLines(ingest);
+    }
+    if(out != stdout && fclose(out) != 0){
+        perror(outName);
+        return 1;
+    }
+    return 0;
+}
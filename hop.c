@@ -0,0 +1,36 @@
+/*
+ * File:   hop.c
+ * Channel plan and hopping sequence, see hop.h.
+ */
+#include "hop.h"
+#include "LoRa.h"
+
+#define PLAN_FRF(hz) LORA_FRF(hz),
+
+const uint32_t hopPlan[HOP_CHANNELS] = {
+    HOP_PLAN(PLAN_FRF)
+};
+
+//CRC-8 (polynomial 0x07) step, a cheap mix the receiver can repeat
+static uint8_t crc8(uint8_t crc, uint8_t data){
+    crc ^= data;
+    for(uint8_t i=0;i<8;i++){
+        crc = crc & 0x80 ? (uint8_t)(crc<<1) ^ 0x07 : (uint8_t)(crc<<1);
+    }
+    return crc;
+}
+
+/**
+ * Pseudo random channel for a frame.  Each node follows its own sequence,
+ * and the receiver can repeat it from the frame header.
+ * @param node
+ * @param sequence of the frame's first record
+ * @return 0 to HOP_CHANNELS-1
+ */
+uint8_t hopChannel(uint8_t node, uint8_t sequence){
+    return crc8(crc8(0, node), sequence) & (HOP_CHANNELS-1);
+}
+
+uint32_t hopFRF(uint8_t node, uint8_t sequence){
+    return hopPlan[hopChannel(node, sequence)];
+}
@@ -0,0 +1,42 @@
+/*
+ * File:   hop.h
+ * Comments: Channel plan and per packet frequency hopping.
+ * The plan is a list of frequency register words in the 865-868MHz
+ * sub-band, channel 0 being the one the sensor has always used.  With
+ * HOP_ENABLE each frame goes on a channel picked from the node id and the
+ * frame's sequence number, so the receiver can work out where the next
+ * one will be and traffic from many sensors spreads over the band.
+ * The whole plan is one sub-band, so the duty cycle governor still covers
+ * it with one bucket.
+ * Hopping within a packet (HOP_PERIOD_REG, FHSS) is left off as the
+ * receiver would have to follow it.
+ */
+
+#ifndef HOP_H
+#define	HOP_H
+
+#include <stdint.h>
+
+#ifndef HOP_ENABLE
+#define HOP_ENABLE 0 //1 to hop per packet
+#endif
+#define HOP_CHANNELS 8 //Power of 2
+#define HOP_HOME_HZ 866500000UL //Channel 0
+
+//The plan in Hz, channel 0 first, as CHANNEL(hz) for each.  125kHz
+//channels, all inside 865.0-868.0MHz.
+#define HOP_PLAN(CHANNEL) \
+    CHANNEL(HOP_HOME_HZ) \
+    CHANNEL(865100000UL) \
+    CHANNEL(865500000UL) \
+    CHANNEL(865900000UL) \
+    CHANNEL(866300000UL) \
+    CHANNEL(866900000UL) \
+    CHANNEL(867300000UL) \
+    CHANNEL(867700000UL)
+
+extern const uint32_t hopPlan[HOP_CHANNELS]; //Frequency register words, see LORA_FRF
+uint8_t hopChannel(uint8_t, uint8_t); //Node id, frame sequence number.  Channel to use when hopping.
+uint32_t hopFRF(uint8_t, uint8_t); //As hopChannel, but the frequency register word
+
+#endif	/* HOP_H */
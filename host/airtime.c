@@ -0,0 +1,106 @@
+/*
+ * File:   airtime.c
+ * Time on air and charge per packet for a modem and PA configuration.
+ * The time on air comes from LoRaAirTimeUs in the driver, so it is the
+ * same number the firmware works out.  Transmit current is taken from the
+ * SX1276 datasheet IDDT figures for the output power the PA registers
+ * give (current.c).
+ * Usage: loraairtime [-s sf] [-b bw] [-c cr] [-p preamble] [-P paConfig]
+ *                    [-D paDac] [-i mA] [length...]
+ * Modem settings default to LoRaProfile.h, PA settings to the values in
+ * LoRaOptimalProfile, lengths to the wind frame sizes.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../LoRa.h"
+#include "../LoRaProfile.h"
+#include "current.h"
+
+#define OVERHEAD_US 1000 //Standby time per packet, SPI set up and TxDone handling
+#define PACKETS_PER_YEAR (60.0*24*365)
+
+//Looks a register up in a LoRaLoadProfile table
+static int profileValue(const uint8_t* table, uint8_t reg){
+    while(table[1] != 0){
+        if(reg >= table[0] && reg < table[0] + table[1]){
+            return table[2 + reg - table[0]];
+        }
+        table += table[1] + 2;
+    }
+    return -1;
+}
+
+static void usage(){
+    fprintf(stderr, "usage: loraairtime [-s sf] [-b bw 0-9] [-c cr 1-4] [-p preamble]"
+            " [-P paConfig] [-D paDac] [-i mA] [length...]\n");
+    exit(1);
+}
+
+int main(int argc, char **argv){
+    static const uint8_t defaultLengths[] = {5, 6, 14, 24, 50, 255};
+    uint8_t sf = LORA_SF;
+    uint8_t bw = LORA_BW;
+    uint8_t cr = LORA_CR;
+    uint16_t preamble = LORA_PREAMBLE;
+    int paConfig = profileValue(LoRaOptimalProfile, PA_CONFIG_REG);
+    int paDac = profileValue(LoRaOptimalProfile, PA_DAC_REG);
+    double current = 0;
+    int i = 1;
+    for(;i<argc && argv[i][0] == '-' && argv[i][1] != 0;i++){
+        if(i + 1 >= argc){
+            usage();
+        }
+        long value = strtol(argv[i+1], 0, 0);
+        switch(argv[i][1]){
+            case 's': sf = value; break;
+            case 'b': bw = value; break;
+            case 'c': cr = value; break;
+            case 'p': preamble = value; break;
+            case 'P': paConfig = value; break;
+            case 'D': paDac = value; break;
+            case 'i': current = strtod(argv[i+1], 0); break;
+            default: usage();
+        }
+        i++;
+    }
+    if(sf < 6 || sf > 12 || bw > 9 || cr < 1 || cr > 4 || paConfig < 0 || paDac < 0){
+        usage();
+    }
+    //Same rule as LoRaProfile.h: symbols over 16ms need low data rate optimisation
+    static const uint8_t bwDivider[10] = {64, 48, 32, 24, 16, 12, 8, 4, 2, 1};
+    uint8_t ldro = ((2UL<<sf)*bwDivider[bw]) > 16000;
+    uint8_t config1 = bw<<4 | cr<<1 | LORA_IMPLICIT_HEADER;
+    uint8_t config2 = sf<<4 | LORA_CRC_ON<<2;
+    uint8_t config3 = ldro<<3 | 0x04;
+    double dBm = currentOutputDbm(paConfig, paDac);
+    if(current == 0){
+        current = currentTxMA(paConfig, dBm);
+    }
+
+    printf("SF%u BW%u CR4/%u preamble %u%s%s, PA 0x%02X DAC 0x%02X = %.1fdBm, %.1fmA\n",
+           sf, bw, cr + 4, preamble, LORA_CRC_ON ? " CRC" : "",
+           ldro ? " LDRO" : "", paConfig, paDac, dBm, current);
+    printf("%6s %10s %10s %10s %14s\n", "bytes", "air us", "uC", "uAh", "mAh/yr @1/min");
+    uint8_t count = 0;
+    for(;;count++){
+        uint8_t length;
+        if(i < argc){
+            if(count + i >= argc){
+                break;
+            }
+            length = atoi(argv[i + count]);
+        }
+        else{
+            if(count >= sizeof(defaultLengths)){
+                break;
+            }
+            length = defaultLengths[count];
+        }
+        uint32_t airUs = LoRaAirTimeUs(config1, config2, config3, preamble, length);
+        double charge = (current*airUs + CURRENT_RADIO_STANDBY_MA*OVERHEAD_US)/1000.0; //uC
+        printf("%6u %10lu %10.1f %10.4f %14.2f\n", length, (unsigned long)airUs,
+               charge, charge/3600.0, charge/3600.0*PACKETS_PER_YEAR/1000.0);
+    }
+    return 0;
+}
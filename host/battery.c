@@ -0,0 +1,254 @@
+/*
+ * File:   battery.c
+ * Battery life of the sensor, from the firmware itself.  The scheduler,
+ * wind counting, report batching, EEPROM log, duty cycle governor and
+ * radio driver run as they do on the PIC, against the simulated SX1276
+ * (simSX1276.c) and PIC peripherals (simPIC.c), with a 2s count of tacho
+ * pulses fed into Timer3 before each watchdog wake.  A year takes a few
+ * seconds.
+ * The time spent in each state is turned into charge with the currents in
+ * current.h and projected onto a year, then the battery life worked out
+ * from the capacity less self discharge.
+ * Counts come from a file of whitespace separated 2s pulse counts, as
+ * recorded, repeated to fill the time if it's short.  Without a file a
+ * synthetic wind is made up (see synthetic()).
+ * Instruction time isn't modelled by the simulators, so each wake is
+ * charged a fixed number of instruction cycles, at whatever the clock is
+ * then (clock.h), on top of the SPI and delay time they count.
+ * The supply the ADC sees is fixed for the run, so -v below SUPPLY_LOW_MV
+ * or SUPPLY_CRITICAL_MV shows what the low battery policy (supply.h) saves.
+ * Usage: lorabattery [-d days] [-w wake cycles] [-r 16MHz run mA] [-c mAh]
+ *                    [-s self discharge %/year] [-v supply mV] [-g years] [file]
+ *   -g  exits with 1 if the projected life is under that many years, so
+ *       a release can be gated on its energy budget
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "../LoRa.h"
+#include "../LoRaHAL.h"
+#include "../scheduler.h"
+#include "../report.h"
+#include "../wind.h"
+#include "../settings.h"
+#include "../hop.h"
+#include "../clock.h"
+#include "../supply.h"
+#include "simSX1276.h"
+#include "simPIC.h"
+#include "current.h"
+
+#define TX_FREQ HOP_HOME_HZ //As main.c
+#define SYNC_WORD 0x55
+#define DEFAULT_DAYS 365
+#define DEFAULT_WAKE_CYCLES 400 //schedulerTick and windSample, 100us at 16MHz
+#define DEFAULT_CAPACITY_MAH 7000.0 //2 x C alkaline in series, to 0.9V a cell at low drain
+#define DEFAULT_SELF_DISCHARGE 2.0 //Percent of capacity a year
+#define TACHO_ON_FRACTION 0.5 //Reed switch closed for half of each turn, or either way at rest
+#define TICKS_PER_DAY (86400000UL/SCHED_TICK_MS)
+#define US_PER_HOUR 3600000000.0
+
+void windTask(void);
+
+//Same as main.c without the debug heartbeat
+Task tasks[] = {
+    {windTask, 1, 0, 0, 0, 0},
+    {reportTask, SCHED_TICKS_PER_MINUTE, 0, 0, 0, 0},
+    {reportSendTask, SCHED_ONE_SHOT, 0, 0, 0, 0},
+    {supplyTask, SUPPLY_EVERY_MINUTES*SCHED_TICKS_PER_MINUTE, 0, 0, 0, 0},
+};
+
+void windTask(){
+    windSample();
+}
+
+static uint16_t* counts; //From the file
+static size_t countTotal;
+
+//Repeatable, so a result can be reproduced
+static uint32_t lcg = 12345;
+static double uniform(){
+    lcg = lcg*1664525UL + 1013904223UL;
+    return ((lcg>>8) + 0.5)/16777216.0;
+}
+
+static double gaussian(){
+    return sqrt(-2*log(uniform()))*cos(2*M_PI*uniform());
+}
+
+/**
+ * Makes up a 2s count.  The hourly mean is Weibull with shape 2 (Rayleigh)
+ * and a mean of about 22 counts, moved a third of the way towards a fresh
+ * draw each hour so it changes over hours rather than jumping.  Within the
+ * hour the counts have 25% turbulence and 1 in 100 are a gust 2.5 times
+ * the mean, which is enough to trip REPORT_GUST_SEND in a strong wind.
+ * @param tick
+ * @return pulses
+ */
+static uint16_t synthetic(uint32_t tick){
+    static double hourMean = 22;
+    if(tick % (TICKS_PER_DAY/24) == 0){
+        hourMean += (25*sqrt(-log(uniform())) - hourMean)/3;
+    }
+    double value = hourMean*(1 + 0.25*gaussian());
+    if(uniform() < 0.01){
+        value *= 2.5;
+    }
+    return value < 0 ? 0 : (uint16_t)(value + 0.5);
+}
+
+static void readCounts(const char* name){
+    FILE* file = fopen(name, "r");
+    size_t size = 0;
+    unsigned value;
+    if(!file){
+        perror(name);
+        exit(1);
+    }
+    while(fscanf(file, "%u", &value) == 1){
+        if(countTotal == size){
+            size = size ? 2*size : 4096;
+            counts = realloc(counts, size*sizeof(counts[0]));
+            if(!counts){
+                perror("realloc");
+                exit(1);
+            }
+        }
+        counts[countTotal++] = value;
+    }
+    fclose(file);
+    if(countTotal == 0){
+        fprintf(stderr, "%s: no counts\n", name);
+        exit(1);
+    }
+}
+
+//The firmware's start up from main.c, after a power on
+static void powerOn(){
+    simPowerOn();
+    simPICPowerOn();
+    settingsLoad();
+    supplyInit();
+    LoRaReset();
+    LoRaStart(LORA_FRF(TX_FREQ), SYNC_WORD);
+    LoRaSleepMode();
+    settingsApplyRadio();
+    LoRaHALDisable(); //Stands in for shutdown() and clockSlow()
+    windInit();
+    reportInit();
+    schedulerInit(tasks, sizeof(tasks)/sizeof(tasks[0]));
+}
+
+typedef struct {
+    const char* name;
+    double us; //Time in the state
+    double mA;
+} State;
+
+static void usage(){
+    fprintf(stderr, "usage: lorabattery [-d days] [-w wake cycles] [-r 16MHz run mA] [-c mAh]"
+            " [-s self discharge %%/year] [-v supply mV] [-g years] [file]\n");
+    exit(1);
+}
+
+int main(int argc, char **argv){
+    double days = DEFAULT_DAYS;
+    double wakeCycles = DEFAULT_WAKE_CYCLES;
+    double runMA = CURRENT_PIC_RUN_MA;
+    double capacity = DEFAULT_CAPACITY_MAH;
+    double selfDischarge = DEFAULT_SELF_DISCHARGE;
+    double gate = 0;
+    double supply = SIM_SUPPLY_MV;
+    int i = 1;
+    for(;i<argc && argv[i][0] == '-' && argv[i][1] != 0;i++){
+        if(i + 1 >= argc){
+            usage();
+        }
+        double value = strtod(argv[i+1], 0);
+        switch(argv[i][1]){
+            case 'd': days = value; break;
+            case 'w': wakeCycles = value; break;
+            case 'r': runMA = value; break;
+            case 'c': capacity = value; break;
+            case 's': selfDischarge = value; break;
+            case 'v': supply = value; break;
+            case 'g': gate = value; break;
+            default: usage();
+        }
+        i++;
+    }
+    if(days <= 0 || wakeCycles < 0 || capacity <= 0 || supply < 1100 || supply > 5500 || i + 1 < argc){
+        usage();
+    }
+    if(i < argc){
+        readCounts(argv[i]);
+    }
+
+    simSetSupplyMv(supply);
+    clock_t started = clock();
+    uint32_t ticks = days*TICKS_PER_DAY;
+    uint32_t packets = 0;
+    uint64_t pulses = 0;
+    powerOn();
+    for(uint32_t tick=0;tick<ticks;tick++){
+        uint16_t count = countTotal ? counts[tick % countTotal] : synthetic(tick);
+        uint8_t sent = simTxCount();
+        simSleepPic(SCHED_TICK_MS*1000UL); //SLEEP() until the watchdog
+        simPulses(count);
+        pulses += count;
+        simAdvanceUs(wakeCycles*4e6/simPicHz());
+        schedulerTick();
+        packets += (uint8_t)(simTxCount() - sent);
+    }
+    double wall = (double)(clock() - started)/CLOCKS_PER_SEC;
+
+    uint8_t paConfig = simPeekReg(PA_CONFIG_REG);
+    double elapsed = simElapsedUs();
+    State states[] = {
+        {"PIC asleep", simPicSleepUs() - simEepromWriteUs(), CURRENT_PIC_SLEEP_MA},
+        {"PIC idle", simPicIdleUs(), CURRENT_PIC_IDLE_MA},
+        {"PIC awake fast", simAwakeUs(1), runMA},
+        {"PIC awake slow", simAwakeUs(0), currentPicMA(CLOCK_SLOW_HZ)},
+        {"EEPROM write", simEepromWriteUs(), CURRENT_PIC_SLEEP_MA + CURRENT_EEPROM_WRITE_MA},
+        {"tacho pull up", elapsed*TACHO_ON_FRACTION, CURRENT_TACHO_ON_MA},
+        {"radio sleep", simModeUs(SLEEP_MODE), CURRENT_RADIO_SLEEP_MA},
+        {"radio standby", simModeUs(STANDBY_MODE), CURRENT_RADIO_STANDBY_MA},
+        {"radio synth", simModeUs(FREQ_SYNTH_TX_MODE) + simModeUs(FREQ_SYNTH_RX_MODE), CURRENT_RADIO_FS_MA},
+        {"radio TX", simModeUs(TX_MODE), currentTxMA(paConfig, currentOutputDbm(paConfig, simPeekReg(PA_DAC_REG)))},
+        {"radio RX", simModeUs(RX_CONT_MODE) + simModeUs(RX_SINGLE_MODE), CURRENT_RADIO_RX_MA},
+        {"radio CAD", simModeUs(CAD_MODE), CURRENT_RADIO_RX_MA},
+    };
+    double year = 365*86400e6/elapsed; //Scales the run to a year
+    double total = 0;
+    for(uint8_t k=0;k<sizeof(states)/sizeof(states[0]);k++){
+        total += states[k].us*states[k].mA;
+    }
+    total *= 1000/US_PER_HOUR*year; //uAh a year
+
+    printf("%.1f days in %.2fs, %lu packets, %.2fs on air, %lu EEPROM bytes written\n",
+           elapsed/86400e6, wall, (unsigned long)packets, simModeUs(TX_MODE)/1e6,
+           (unsigned long)simEepromWrites());
+    printf("Mean wind %.1f pulses/2s, PIC %.2fMHz/%.2fMHz, %.0f cycles a wake, %.1fus awake a wake\n",
+           (double)pulses/ticks, CLOCK_FAST_HZ/1e6, CLOCK_SLOW_HZ/1e6, wakeCycles,
+           (simAwakeUs(0) + simAwakeUs(1))/(double)ticks);
+    static const char* levels[] = {"OK", "low", "critical"};
+    printf("Supply %.0fmV measured %umV, %s, batch %u minutes, %udBm\n", supply, supplyMv(),
+           levels[supplyLevel()], supplyBatchMinutes(), supplyPowerDbm());
+    printf("%-14s %12s %10s %12s %7s\n", "state", "s/year", "mA", "uAh/year", "share");
+    for(uint8_t k=0;k<sizeof(states)/sizeof(states[0]);k++){
+        double charge = states[k].us*states[k].mA*1000/US_PER_HOUR*year;
+        printf("%-14s %12.1f %10.4f %12.1f %6.1f%%\n", states[k].name,
+               states[k].us/1e6*year, states[k].mA, charge, 100*charge/total);
+    }
+    double life = capacity/(total/1000 + capacity*selfDischarge/100);
+    printf("%-14s %12s %10.4f %12.1f\n", "total", "", total/(24*365)/1000, total);
+    printf("Mean %.2fuA, %.1fmAh battery with %.1f%%/year self discharge lasts %.1f years\n",
+           total/(24*365), capacity, selfDischarge, life);
+    if(gate > 0 && life < gate){
+        printf("FAIL: under the %.1f year budget\n", gate);
+        return 1;
+    }
+    return 0;
+}
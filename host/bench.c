@@ -0,0 +1,164 @@
+/*
+ * File:   bench.c
+ * Runs the radio driver against the simulated SX1276 and reports the SPI
+ * cost of each API call: transactions (SS assertions), bytes clocked, bus
+ * time, delay time and total modelled time.
+ * Usage: lorabench [-c]   (-c prints CSV for regression diffs)
+ */
+#include <stdio.h>
+#include <string.h>
+#include "../LoRa.h"
+#include "../LoRaProfile.h"
+#include "simSX1276.h"
+#include "../frame.h"
+
+#define TX_FREQ 866500000UL //Hz
+#define SYNC_WORD 0x55
+#define FRAME_LENGTH 50 //Wind frame size from the README
+#define MAX_RESULTS 32
+
+typedef struct {
+    const char *name;
+    SimStats stats;
+} BenchResult;
+
+static BenchResult results[MAX_RESULTS];
+static uint8_t resultCount;
+
+static void record(const char *name){
+    if(resultCount < MAX_RESULTS){
+        results[resultCount].name = name;
+        results[resultCount].stats = simStatsGet();
+        resultCount++;
+    }
+}
+
+//A full wake -> transmit -> sleep cycle as main() will run it
+static void txCycle(uint8_t *frame, uint8_t length){
+    LoRaTXData(frame, length);
+    simAdvanceUs(simLastTxAirUs() + 1000); //Packet on air, not counted
+    LoRaClearIRQFlags();
+    LoRaSleepMode();
+}
+
+//Runs one driver call with the counters cleared and stores what it cost
+#define BENCH(name, call) do { simStatsReset(); call; record(name); } while(0)
+
+static void printTable(){
+    uint8_t i;
+    printf("\n%-22s %6s %6s %9s %9s %9s %9s %6s\n", "API call", "trans",
+           "bytes", "bus us", "delay us", "total us", "sleep us", "faults");
+    for(i=0;i<resultCount;i++){
+        SimStats *s = &results[i].stats;
+        printf("%-22s %6lu %6lu %9lu %9lu %9lu %9lu %6lu\n", results[i].name,
+               (unsigned long)s->transactions, (unsigned long)s->bytes,
+               (unsigned long)s->busUs, (unsigned long)s->delayUs,
+               (unsigned long)(s->busUs + s->delayUs),
+               (unsigned long)s->sleepUs, (unsigned long)s->faults);
+    }
+    printf("SPI byte time %lu us, last packet %u bytes, %lu us on air\n",
+           (unsigned long)simSpiByteUs(), simLastTxLength(),
+           (unsigned long)simLastTxAirUs());
+}
+
+static void printCsv(){
+    uint8_t i;
+    printf("call,transactions,bytes,bus_us,delay_us,total_us,sleep_us,faults\n");
+    for(i=0;i<resultCount;i++){
+        SimStats *s = &results[i].stats;
+        printf("%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n", results[i].name,
+               (unsigned long)s->transactions, (unsigned long)s->bytes,
+               (unsigned long)s->busUs, (unsigned long)s->delayUs,
+               (unsigned long)(s->busUs + s->delayUs),
+               (unsigned long)s->sleepUs, (unsigned long)s->faults);
+    }
+}
+
+int main(int argc, char **argv){
+    uint8_t frame[FRAME_LENGTH];
+    uint8_t i;
+    uint8_t verified = 0;
+    uint8_t sent = 0;
+    uint8_t warm = 0;
+    uint32_t fullAirUs;
+    uint8_t wind[FRAME_MAX_LENGTH];
+    uint8_t windLength;
+    WindFrame last = {1, 1, 900, 40, 70, 0, 0, 0}; //Typical minute, 900 pulses, gust 40, spread 4.4
+    WindFrame next = {1, 2, 912, 37, 61, 0, 0, 0};
+    WindFrame batch[5] = {{1, 2, 912, 37, 61, 0, 0, 0}, {1, 3, 905, 41, 75, 0, 0, 0}, {1, 4, 880, 35, 58, 0, 0, 0},
+                          {1, 5, 931, 44, 80, 0, 0, 0}, {1, 6, 920, 39, 66, 0, 0, 0}};
+    uint8_t batchLength;
+    uint32_t windAirUs;
+    uint32_t airUs = 0;
+    uint8_t clear = 0;
+    uint8_t busy = 0;
+    uint8_t command[12] = {0x20, 1, 1, 0, 1, 5, 2, 9}; //Batch 5, SF9, before the MAC
+    uint8_t received[16];
+    uint8_t heard = 0;
+    uint8_t missed = 1;
+    uint8_t sf = LORA_SF < 12 ? LORA_SF + 1 : 11; //Off the profile
+    uint8_t stale = 1;
+    for(i=0;i<FRAME_LENGTH;i++){
+        frame[i] = i;
+    }
+
+    simPowerOn();
+    simAdvanceUs(10000); //Power on settling before main() runs
+
+    BENCH("LoRaReset", LoRaReset());
+    BENCH("LoRaStart", LoRaStart(LORA_FRF(TX_FREQ), SYNC_WORD));
+    BENCH("LoRaOptimalLoad", LoRaOptimalLoad(SYNC_WORD));
+    BENCH("LoRaSetFrequency", LoRaSetFrequency(TX_FREQ));
+    BENCH("LoRaSleepMode", LoRaSleepMode());
+    BENCH("LoRaStandbyMode", LoRaStandbyMode());
+    BENCH("LoRaTXData(50)", LoRaTXData(frame, FRAME_LENGTH));
+    simAdvanceUs(simLastTxAirUs() + 1000); //Let the packet go
+    BENCH("LoRaGetIRQFlags", LoRaGetIRQFlags());
+    BENCH("LoRaClearIRQFlags", LoRaClearIRQFlags());
+    BENCH("LoRaSleepMode", LoRaSleepMode());
+    BENCH("TX cycle(50)", txCycle(frame, FRAME_LENGTH));
+    BENCH("TX cycle(50) again", txCycle(frame, FRAME_LENGTH));
+    BENCH("LoRaTXDataSleep(50)", sent = LoRaTXDataSleep(frame, FRAME_LENGTH, 2));
+    fullAirUs = simLastTxAirUs();
+    windLength = frameEncode(wind, &next, 1, &last);
+    BENCH("LoRaTXDataSleep(wind)", sent &= LoRaTXDataSleep(wind, windLength, 2));
+    windAirUs = simLastTxAirUs();
+    batchLength = frameEncode(wind, batch, 5, &last);
+    BENCH("LoRaTXDataSleep(5 min)", sent &= LoRaTXDataSleep(wind, batchLength, 2));
+    BENCH("LoRaTimeOnAir", airUs = LoRaTimeOnAir(batchLength));
+    BENCH("LoRaCAD clear", clear = !LoRaCAD());
+    simSetChannelBusy(1);
+    BENCH("LoRaCAD busy", busy = LoRaCAD());
+    simSetChannelBusy(0);
+    LoRaSleepMode();
+    BENCH("LoRaRXSingle timeout", missed = LoRaRXSingle(received, sizeof(received), 100));
+    simQueueDownlink(command, sizeof(command));
+    BENCH("LoRaRXSingle(12)", heard = LoRaRXSingle(received, sizeof(received), 100));
+    BENCH("LoRaShadowResync", LoRaShadowResync());
+    BENCH("LoRaShadowVerify", verified = LoRaShadowVerify());
+    LoRaSetSpreadingFactor(sf); //As a downlink would
+    BENCH("LoRaWarmStart", warm = LoRaWarmStart(LORA_FRF(TX_FREQ), SYNC_WORD, sf, LORA_POWER_DBM));
+    stale = LoRaWarmStart(LORA_FRF(TX_FREQ), SYNC_WORD, LORA_SF, LORA_POWER_DBM);
+
+    if(argc > 1 && strcmp(argv[1], "-c") == 0){
+        printCsv();
+    }
+    else{
+        printTable();
+        printf("Register shadow %s\n", verified ? "matches module" : "MISMATCH");
+        printf("Sleeping transmit %s\n", sent ? "completed on TxDone" : "TIMED OUT");
+        printf("Warm start %s\n", warm && !stale ? "accepted the module and refused a stale spreading factor" : "WRONG");
+        printf("Wind frame %u bytes, %lu us on air against %lu us for %u bytes\n",
+               windLength, (unsigned long)windAirUs,
+               (unsigned long)fullAirUs, FRAME_LENGTH);
+        printf("CAD %s\n", clear && busy ? "found the clear and busy channels" : "WRONG");
+        printf("Receive window %s\n", heard == sizeof(command) && !missed &&
+               memcmp(received, command, sizeof(command)) == 0 ? "timed out empty and got the downlink" : "WRONG");
+        printf("Time on air %lu us from the driver, %lu us from the model\n",
+               (unsigned long)airUs, (unsigned long)simLastTxAirUs());
+        printf("5 minutes batched %u bytes, %lu us on air against %lu us sent singly\n",
+               batchLength, (unsigned long)simLastTxAirUs(),
+               (unsigned long)(5*windAirUs));
+    }
+    return 0;
+}
@@ -0,0 +1,57 @@
+/*
+ * File:   current.c
+ * Transmit current from the PA settings and PIC current from the clock
+ * rate, see current.h.
+ * Between the datasheet IDDT figures the current is interpolated, below
+ * the lowest one the lowest is used, so the result is an upper bound there.
+ */
+#include "current.h"
+
+/**
+ * Output power from RegPaConfig and RegPaDac (SX1276 datasheet 5.4.3).
+ * @return dBm
+ */
+double currentOutputDbm(uint8_t paConfig, uint8_t paDac){
+    uint8_t outputPower = paConfig & 0x0F;
+    if(paConfig & 0x80){ //PA_BOOST pin
+        if((paDac & 0x07) == 0x07){
+            return 20.0 - (15 - outputPower); //+20dBm option
+        }
+        return 17.0 - (15 - outputPower);
+    }
+    return 10.8 + 0.6*((paConfig>>4) & 0x07) - (15 - outputPower); //RFO pin
+}
+
+static double interpolate(double x, double x0, double y0, double x1, double y1){
+    if(x <= x0){
+        return y0;
+    }
+    if(x >= x1){
+        return y1;
+    }
+    return y0 + (x - x0)*(y1 - y0)/(x1 - x0);
+}
+
+/**
+ * Transmit current for an output power (SX1276 datasheet IDDT).
+ * PA_BOOST: 87mA at +17dBm, 120mA at +20dBm.  RFO: 20mA at +7dBm, 29mA
+ * at +13dBm.
+ * @return mA
+ */
+double currentTxMA(uint8_t paConfig, double dBm){
+    if(paConfig & 0x80){
+        return interpolate(dBm, 17.0, 87.0, 20.0, 120.0);
+    }
+    return interpolate(dBm, 7.0, 20.0, 13.0, 29.0);
+}
+
+/**
+ * PIC run current, on a straight line through the 1MHz and 16MHz figures.
+ * The part that doesn't scale with the clock (HFINTOSC, regulator) makes
+ * each instruction cost more charge at slower rates.
+ * @param hz
+ * @return mA
+ */
+double currentPicMA(uint32_t hz){
+    return CURRENT_PIC_1MHZ_MA + (hz - 1e6)*(CURRENT_PIC_RUN_MA - CURRENT_PIC_1MHZ_MA)/15e6;
+}
@@ -0,0 +1,29 @@
+/*
+ * File:   current.h
+ * Comments: Supply current of the sensor in each state, for the host
+ * tools that turn simulated time into charge.  Radio figures are SX1276
+ * datasheet typicals (table 2-4, 868MHz band, 3.3V), PIC figures are
+ * PIC18LF46K22 typicals at 3V or measured on PCB000044 (see main.c).
+ */
+
+#ifndef CURRENT_H
+#define	CURRENT_H
+
+#include <stdint.h>
+
+#define CURRENT_RADIO_SLEEP_MA 0.0002 //IDDSL
+#define CURRENT_RADIO_STANDBY_MA 1.6 //IDDST
+#define CURRENT_RADIO_FS_MA 5.8 //IDDFS, FSTX and FSRX
+#define CURRENT_RADIO_RX_MA 11.5 //IDDR_L at 125kHz, CAD is taken as the same
+#define CURRENT_PIC_SLEEP_MA 0.0008 //Everything shut down, WDT and Timer3 running.  Under 1uA measured with the module asleep.
+#define CURRENT_PIC_RUN_MA 3.0 //IDD at 16MHz HF-INTOSC
+#define CURRENT_PIC_1MHZ_MA 0.45 //IDD at 1MHz, HF-INTOSC through the postscaler
+#define CURRENT_PIC_IDLE_MA 1.0 //IDD in RC_IDLE at 16MHz, CPU stopped.  Taken as a third of the run current, to be measured on PCB000044.
+#define CURRENT_TACHO_ON_MA 0.005 //1M pull up through the closed reed switch, 6uA measured less the sleep current
+#define CURRENT_EEPROM_WRITE_MA 3.0 //PIC asleep while the cell programs.  No datasheet figure, taken as the run current.
+
+double currentOutputDbm(uint8_t, uint8_t); //RegPaConfig and RegPaDac to output power
+double currentTxMA(uint8_t, double); //RegPaConfig and output power to IDDT
+double currentPicMA(uint32_t); //PIC run current at a clock rate in Hz
+
+#endif	/* CURRENT_H */
@@ -0,0 +1,79 @@
+/*
+ * File:   framecheck.c
+ * Decode checks for the wind frame (frame.h): every encoding round trips,
+ * and frames a sensor could never send are refused rather than decoded
+ * into something plausible.  Exits with 1 on any failure.
+ * Usage: loraframe [-v]
+ *   -v  prints every case
+ */
+#include <stdio.h>
+#include <string.h>
+#include "../frame.h"
+
+#define HEADER(flags) (FRAME_VERSION<<FRAME_VERSION_SHIFT | (flags))
+
+static int verbose;
+static int failed;
+static int checked;
+
+static void expect(const char* name, int ok){
+    checked++;
+    if(!ok){
+        failed++;
+    }
+    if(!ok || verbose){
+        printf("%s %s\n", ok ? "ok" : "FAIL", name);
+    }
+}
+
+static uint8_t decode(const uint8_t* buffer, uint8_t length, WindFrame* frames){
+    uint8_t count = FRAME_MAX_RECORDS;
+    return frameDecode(frames, &count, buffer, length, 0);
+}
+
+//Encodes then decodes a single absolute record
+static int roundTrip(const WindFrame* frame){
+    uint8_t buffer[FRAME_MAX_LENGTH];
+    WindFrame out[FRAME_MAX_RECORDS];
+    uint8_t length = frameEncode(buffer, frame, 1, 0);
+    return decode(buffer, length, out) == FRAME_OK && out[0].total == frame->total &&
+            out[0].gust == frame->gust && out[0].spread == frame->spread &&
+            out[0].status == frame->status && out[0].supply == frame->supply &&
+            out[0].held == frame->held;
+}
+
+static void varints(){
+    WindFrame out[FRAME_MAX_RECORDS];
+    //Total in the third byte, gust 0
+    const uint8_t largest[] = {HEADER(0), 1, 0, 0xFF, 0xFF, 0x03, 0x00};
+    const uint8_t over16[] = {HEADER(0), 1, 0, 0xFF, 0xFF, 0x04, 0x00};
+    const uint8_t over16Top[] = {HEADER(0), 1, 0, 0x80, 0x80, 0x7F, 0x00};
+    const uint8_t fourBytes[] = {HEADER(0), 1, 0, 0xFF, 0xFF, 0x83, 0x00, 0x00};
+    const uint8_t truncated[] = {HEADER(0), 1, 0, 0xFF, 0xFF};
+    expect("0xFFFF in 3 bytes decodes",
+           decode(largest, sizeof(largest), out) == FRAME_OK && out[0].total == 0xFFFF);
+    expect("third byte 0x04 refused", decode(over16, sizeof(over16), out) == FRAME_BAD_LENGTH);
+    expect("third byte 0x7F refused", decode(over16Top, sizeof(over16Top), out) == FRAME_BAD_LENGTH);
+    expect("4 byte varint refused", decode(fourBytes, sizeof(fourBytes), out) == FRAME_BAD_LENGTH);
+    expect("truncated varint refused", decode(truncated, sizeof(truncated), out) == FRAME_BAD_LENGTH);
+}
+
+static void roundTrips(){
+    static const uint16_t values[] = {0, 1, 0x7F, 0x80, 0x3FFF, 0x4000, 0xFFFF};
+    char name[64];
+    for(unsigned i=0;i<sizeof(values)/sizeof(values[0]);i++){
+        WindFrame frame = {7, 0, values[i], values[i], values[i], 0, 0, 0};
+        snprintf(name, sizeof(name), "round trip %u", values[i]);
+        expect(name, roundTrip(&frame));
+    }
+    WindFrame status = {7, 0, 100, 20, 16, FRAME_STATUS_RESTART, 2950, 3};
+    expect("round trip status, held and supply", roundTrip(&status));
+}
+
+int main(int argc, char **argv){
+    verbose = argc > 1 && strcmp(argv[1], "-v") == 0;
+    varints();
+    roundTrips();
+    printf("%d cases, %d failures\n", checked, failed);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,68 @@
+/*
+ * File:   frf.c
+ * Checks the integer frequency register maths (LORA_FRF) against the
+ * single precision path it replaced, freqMHz*16384 truncated, on every
+ * channel of the hopping plan (hop.h), the profile's LORA_FREQ_HZ and
+ * every 25kHz step from 863 to 870MHz.  The MSB, MID and LSB bytes must
+ * all agree.  Exits with 1 on any mismatch.
+ * Usage: lorafrf [-v]
+ *   -v  prints every channel
+ */
+#include <stdio.h>
+#include <string.h>
+#include "../LoRa.h"
+#include "../LoRaProfile.h"
+#include "../hop.h"
+
+#define BAND_LOW_HZ 863000000UL
+#define BAND_HIGH_HZ 870000000UL
+#define BAND_STEP_HZ 25000UL
+
+#define PLAN_HZ(hz) hz,
+
+static const uint32_t planHz[HOP_CHANNELS] = {
+    HOP_PLAN(PLAN_HZ)
+};
+
+static int verbose;
+
+//The old LoRaStart, which took the frequency in MHz as a float
+static uint32_t floatFRF(uint32_t hz){
+    return (uint32_t)((float)(hz/1e6)*16384);
+}
+
+/**
+ * @return 1 if the bytes differ
+ */
+static int check(uint32_t hz, uint32_t frf){
+    uint32_t expected = floatFRF(hz);
+    uint8_t msb = expected>>16;
+    uint8_t mid = expected>>8;
+    uint8_t lsb = expected;
+    int bad = LORA_FRF_MSB(hz) != msb || LORA_FRF_MID(hz) != mid || LORA_FRF_LSB(hz) != lsb ||
+            frf != LORA_FRF(hz);
+    if(bad || verbose){
+        printf("%s %lu Hz: %02X %02X %02X, float %02X %02X %02X\n", bad ? "MISMATCH" : "ok",
+               (unsigned long)hz, (unsigned)(frf>>16 & 0xFF), (unsigned)(frf>>8 & 0xFF),
+               (unsigned)(frf & 0xFF), msb, mid, lsb);
+    }
+    return bad;
+}
+
+int main(int argc, char **argv){
+    int failed = 0;
+    int checked = 0;
+    verbose = argc > 1 && strcmp(argv[1], "-v") == 0;
+    for(uint8_t i=0;i<HOP_CHANNELS;i++){
+        failed += check(planHz[i], hopPlan[i]); //The words the firmware actually loads
+        checked++;
+    }
+    failed += check(LORA_FREQ_HZ, LORA_FRF(LORA_FREQ_HZ));
+    checked++;
+    for(uint32_t hz=BAND_LOW_HZ;hz<=BAND_HIGH_HZ;hz+=BAND_STEP_HZ){
+        failed += check(hz, LORA_FRF(hz));
+        checked++;
+    }
+    printf("%d frequencies, %d mismatches\n", checked, failed);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,83 @@
+/*
+ * File:   xc.h
+ * Comments: Stand in for the compiler's device header when scheduler.c,
+ * wind.c and supply.c are built on a PC (host/simPIC.c).  Only the
+ * registers those touch are here, as plain variables.  TMR0L is a function
+ * so reading it latches TMR0H the way the real 16 bit Timer0 does, and
+ * ADCON0bits one so a conversion that was started has finished by the
+ * time GO is looked at.
+ */
+
+#ifndef SIM_XC_H
+#define	SIM_XC_H
+
+#include <stdint.h>
+
+typedef struct {
+    unsigned T0PS:3;
+    unsigned PSA:1;
+    unsigned T0SE:1;
+    unsigned T0CS:1;
+    unsigned T08BIT:1;
+    unsigned TMR0ON:1;
+} T0CONbits_t;
+
+typedef struct {
+    unsigned TMR3ON:1;
+    unsigned T3RD16:1;
+    unsigned nT3SYNC:1;
+    unsigned T3SOSCEN:1;
+    unsigned T3CKPS:2;
+    unsigned TMR3CS:2;
+} T3CONbits_t;
+
+typedef struct {
+    unsigned TMR3MD:1;
+} PMD0bits_t;
+
+typedef struct {
+    unsigned ADCMD:1;
+} PMD2bits_t;
+
+typedef struct {
+    unsigned RC0:1;
+} TRISCbits_t;
+
+typedef struct {
+    unsigned TMR3IE:1;
+} PIE2bits_t;
+
+typedef struct {
+    unsigned ADON:1;
+    unsigned GO:1;
+    unsigned CHS:5;
+} ADCON0bits_t;
+
+typedef struct {
+    unsigned FVRS:2;
+    unsigned FVRST:1;
+    unsigned FVREN:1;
+} VREFCON0bits_t;
+
+extern volatile T0CONbits_t T0CONbits;
+extern volatile uint8_t TMR0H;
+extern volatile T3CONbits_t T3CONbits;
+extern volatile uint8_t T3GCON;
+extern volatile uint8_t TMR3H; //Set by the test harness, see simPIC.h
+extern volatile uint8_t TMR3L;
+extern volatile PMD0bits_t PMD0bits;
+extern volatile PMD2bits_t PMD2bits;
+extern volatile TRISCbits_t TRISCbits;
+extern volatile PIE2bits_t PIE2bits;
+extern volatile uint8_t ADCON1;
+extern volatile uint8_t ADCON2;
+extern volatile uint8_t ADRESH;
+extern volatile uint8_t ADRESL;
+extern volatile VREFCON0bits_t VREFCON0bits;
+
+uint8_t simTimer0Low(void);
+#define TMR0L simTimer0Low()
+volatile ADCON0bits_t* simAdcon0(void);
+#define ADCON0bits (*simAdcon0())
+
+#endif	/* SIM_XC_H */
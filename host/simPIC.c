@@ -0,0 +1,114 @@
+/*
+ * File:   simPIC.c
+ * PIC peripheral model for the host build, see simPIC.h.
+ */
+#include <string.h>
+#include "simPIC.h"
+#include "simSX1276.h"
+#include "pic/xc.h"
+#include "../eeprom.h"
+#include "../clock.h"
+#include "../supply.h"
+
+volatile T0CONbits_t T0CONbits;
+volatile uint8_t TMR0H;
+volatile T3CONbits_t T3CONbits;
+volatile uint8_t T3GCON;
+volatile uint8_t TMR3H;
+volatile uint8_t TMR3L;
+volatile PMD0bits_t PMD0bits;
+volatile TRISCbits_t TRISCbits;
+volatile PIE2bits_t PIE2bits;
+volatile PMD2bits_t PMD2bits;
+volatile uint8_t ADCON1;
+volatile uint8_t ADCON2;
+volatile uint8_t ADRESH;
+volatile uint8_t ADRESL;
+volatile VREFCON0bits_t VREFCON0bits;
+static volatile ADCON0bits_t adcon0;
+static uint16_t vdd = SIM_SUPPLY_MV; //mV
+
+static uint8_t eeprom[EEPROM_SIZE];
+static uint32_t eepromWrites;
+
+void simPICPowerOn(){
+    memset(eeprom, 0xFF, sizeof(eeprom));
+    eepromWrites = 0;
+    TMR3H = 0;
+    TMR3L = 0;
+    VREFCON0bits.FVRST = 1; //Settles at once
+}
+
+void simSetSupplyMv(uint16_t mV){
+    vdd = mV;
+}
+
+/**
+ * Finishes a conversion the firmware has started.  Only the FVR channel is
+ * modelled: its 1.024V as a fraction of VDD, rounded like the ADC does.
+ * Anything else reads 0.
+ */
+volatile ADCON0bits_t* simAdcon0(){
+    if(adcon0.GO){
+        uint16_t result = 0;
+        if(adcon0.ADON && !PMD2bits.ADCMD && adcon0.CHS == 0x1F && VREFCON0bits.FVREN){
+            result = ((uint32_t)SUPPLY_FVR_MV*(SUPPLY_ADC_FULL + 1) + vdd/2)/vdd;
+            if(result > SUPPLY_ADC_FULL){
+                result = SUPPLY_ADC_FULL;
+            }
+        }
+        ADRESH = result>>8;
+        ADRESL = result & 0xFF;
+        adcon0.GO = 0;
+    }
+    return &adcon0;
+}
+
+/**
+ * Counts pulses into Timer3 the way T3CKI would, wrapping at 16 bits.
+ * Nothing is counted until windInit has turned the timer on.
+ * @param pulses
+ */
+void simPulses(uint16_t pulses){
+    if(T3CONbits.TMR3ON){
+        uint16_t count = ((uint16_t)TMR3H<<8 | TMR3L) + pulses;
+        TMR3H = count>>8;
+        TMR3L = count & 0xFF;
+    }
+}
+
+//Instruction cycles run since power on
+uint64_t simCycles(){
+    return simAwakeUs(1)*(CLOCK_FAST_HZ/1000)/4000 + simAwakeUs(0)*(CLOCK_SLOW_HZ/1000)/4000;
+}
+
+uint8_t simTimer0Low(){
+    uint16_t count = T0CONbits.TMR0ON ? simCycles()/SIM_TIMER0_CYCLES : 0;
+    TMR0H = count>>8;
+    return count & 0xFF;
+}
+
+uint32_t simEepromWrites(){
+    return eepromWrites;
+}
+
+uint64_t simEepromWriteUs(){
+    return (uint64_t)eepromWrites*SIM_EEPROM_WRITE_US;
+}
+
+uint8_t eepromRead(uint16_t address){
+    return eeprom[address % EEPROM_SIZE];
+}
+
+void eepromWrite(uint16_t address, uint8_t value){
+    if(eeprom[address % EEPROM_SIZE] == value){
+        return;
+    }
+    eeprom[address % EEPROM_SIZE] = value;
+    eepromWrites++;
+    simSleepPic(SIM_EEPROM_WRITE_US);
+}
+
+uint8_t eepromSupplyOK(){
+    return 1;
+}
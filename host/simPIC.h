@@ -0,0 +1,29 @@
+/*
+ * File:   simPIC.h
+ * Comments: Host-side model of the PIC peripherals the scheduler, wind
+ * counter and EEPROM log use, so they can run on a PC with the radio
+ * model in simSX1276.c.
+ * Timer0 counts the instruction cycles the PIC has run, from the awake
+ * time at each clock rate the radio model keeps.  Timer3 is whatever simPulses has added up.  The data
+ * EEPROM is an array, blank (0xFF) at power on, and a write sleeps the
+ * PIC for EEPROM_WRITE_US.  The ADC converts the FVR against a supply
+ * voltage set by simSetSupplyMv.
+ */
+
+#ifndef SIMPIC_H
+#define	SIMPIC_H
+
+#include <stdint.h>
+
+#define SIM_TIMER0_CYCLES 256 //Fosc/4 with 1:256 prescale
+#define SIM_EEPROM_WRITE_US 4000 //TWE typical
+#define SIM_SUPPLY_MV 3000 //2 x fresh alkaline under load
+
+void simPICPowerOn(void); //Blank EEPROM, counters cleared
+void simPulses(uint16_t); //Tacho pulses to add to Timer3
+uint64_t simCycles(void); //Instruction cycles run since power on
+uint32_t simEepromWrites(void); //Bytes actually written since power on
+uint64_t simEepromWriteUs(void);
+void simSetSupplyMv(uint16_t); //VDD the ADC sees, kept across simPICPowerOn
+
+#endif	/* SIMPIC_H */
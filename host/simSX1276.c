@@ -0,0 +1,559 @@
+/*
+ * File:   simSX1276.c
+ * Host-side SX1276 model used in place of LoRaHAL.c.
+ *
+ * What is modelled:
+ *  - 128 byte register file with LoRa mode reset values
+ *  - SPI framing: first byte after SS low is the address (bit 7 = write),
+ *    following bytes auto-increment the address, except the FIFO (0x00)
+ *    which advances RegFifoAddrPtr instead
+ *  - Op mode: LongRangeMode can only change in sleep, FIFO is cleared and
+ *    not accessible in sleep, TX returns to standby and sets TxDone after
+ *    the packet time-on-air
+ *  - RegIrqFlags is write 1 to clear
+ *  - CAD returns to standby and sets CadDone two symbols later, with
+ *    CadDetected if simSetChannelBusy says someone is transmitting
+ *  - RX single receives a packet queued by simQueueDownlink, as if it
+ *    started the moment the receiver turned on: ValidHeader after the
+ *    preamble and header, RxDone with the payload at RegFifoRxBaseAddr
+ *    after the time on air.  With nothing queued RxTimeout comes after
+ *    the symbol timeout.  Either way the module returns to standby.
+ *  - DIO0 follows RxDone, TxDone or CadDone as selected in RegDioMapping1.
+ *    As on the board, it only reaches the PIC with LORA_DIO0_WIRED
+ *    (defines.h).  Without it LoRaHALDIO0 reads the IRQ flags over SPI and
+ *    LoRaHALSleep polls them as LoRaHAL.c does, idle between reads, so the
+ *    bus, awake and idle time are counted for the build that ships.
+ *  - Reset line: the chip is not ready until 5ms after reset is released
+ *
+ * Timing: each byte costs 8 SPI clocks at the PIC clock/SIM_SPI_DIVIDER,
+ * delays cost what they ask for.  Instruction time on the PIC is not
+ * modelled.  The PIC clock follows clock.h: CLOCK_FAST from power on and
+ * in LoRaHALInit, CLOCK_SLOW after LoRaHALDisable, and the time the PIC
+ * is awake is totalled for each.
+ * For energy figures the time spent in each op mode and the time the PIC
+ * spends asleep are totalled from power on, in 64 bits so a simulated
+ * year fits.  Time is split at TxDone, CadDone and RX events so each
+ * stretch goes to the right mode.
+ */
+#include <math.h>
+#include <string.h>
+#include "../LoRaHAL.h"
+#include "../LoRa.h"
+#include "../clock.h"
+#include "simSX1276.h"
+
+#ifndef SIM_SPI_DIVIDER
+#define SIM_SPI_DIVIDER CLOCK_SPI_DIVIDER //SSP2CON1bits.SSPM as LoRaHAL.c sets it
+#endif
+
+#define RESET_READY_US 5000 //Datasheet: 5ms after a manual reset
+#define OSC_START_US 250 //Datasheet TS_OSC: crystal start up leaving sleep, FIFO unusable until then
+#define WDT_US 2000000UL //2s watchdog from config.h
+
+static uint8_t regs[128];
+static uint8_t fifo[256];
+static uint32_t nowUs;
+static uint32_t readyAtUs;
+static uint32_t oscReadyAtUs;
+static uint8_t inReset;
+static uint8_t selected;
+static uint8_t firstByte;
+static uint8_t writing;
+static uint8_t address;
+static uint32_t txEndUs;
+static uint8_t txActive;
+static uint8_t txCount;
+static uint8_t lastTxLength;
+static uint32_t lastTxAirUs;
+static uint32_t cadEndUs;
+static uint8_t cadActive;
+static uint8_t channelBusy;
+static uint16_t cadCount;
+static uint32_t rxHeaderUs;
+static uint32_t rxEndUs;
+static uint8_t rxActive;
+static uint8_t rxPacket; //The window will receive downlink[]
+static uint8_t downlink[256];
+static uint8_t downlinkLength;
+static uint16_t rxCount;
+static SimStats stats;
+static uint64_t modeUs[8]; //By RegOpMode bits 2-0
+static uint64_t picSleepUs;
+static uint64_t picAwakeUs[2]; //At CLOCK_SLOW, CLOCK_FAST
+static uint64_t picIdleUs;
+static uint32_t picHz;
+static uint8_t picAsleep;
+
+//Reset values of the registers the driver uses (LoRa page)
+static void resetRegisters(){
+    memset(regs, 0, sizeof(regs));
+    memset(fifo, 0, sizeof(fifo));
+    regs[OP_MODE_REG] = 0x09; //FSK, low frequency mode, standby
+    regs[FRF_MSB_REG] = 0x6C;
+    regs[FRF_MID_REG] = 0x80;
+    regs[PA_CONFIG_REG] = 0x4F;
+    regs[PA_RAMP_REG] = 0x09;
+    regs[OCP_REG] = 0x2B;
+    regs[LNA_REG] = 0x20;
+    regs[FIFO_TX_BASE_ADDR_REG] = 0x80;
+    regs[MODEM_CONFIG_1_REG] = 0x72;
+    regs[MODEM_CONFIG_2_REG] = 0x70;
+    regs[SYMB_TIMEOUT_LSB_REG] = 0x64;
+    regs[PREAMBLE_LSB_REG] = 0x08;
+    regs[PAYLOAD_LENGTH_REG] = 0x01;
+    regs[MAX_PAYLOAD_LENGTH_REG] = 0xFF;
+    regs[MODEM_CONFIG_3_REG] = 0x04;
+    regs[SYNC_VALUE_REG] = 0x12;
+    regs[VERSION_REG] = 0x12;
+    regs[TXCO_REG] = 0x09;
+    regs[PA_DAC_REG] = 0x84;
+    txActive = 0;
+    cadActive = 0;
+    rxActive = 0;
+}
+
+/**
+ * Semtech time-on-air formula (AN1200.13) from the current modem registers.
+ * @param payloadLength bytes
+ * @return microseconds
+ */
+static uint32_t timeOnAirUs(uint8_t payloadLength){
+    static const double bwTable[10] = {500e3/64, 500e3/48, 500e3/32, 500e3/24, 500e3/16,
+                                       500e3/12, 500e3/8, 500e3/4, 500e3/2, 500e3};
+    uint8_t bwIndex = regs[MODEM_CONFIG_1_REG] >> 4;
+    uint8_t cr = (regs[MODEM_CONFIG_1_REG] >> 1) & 0x07;
+    uint8_t implicitHeader = regs[MODEM_CONFIG_1_REG] & 0x01;
+    uint8_t sf = regs[MODEM_CONFIG_2_REG] >> 4;
+    uint8_t crc = (regs[MODEM_CONFIG_2_REG] >> 2) & 0x01;
+    uint8_t ldro = (regs[MODEM_CONFIG_3_REG] >> 3) & 0x01;
+    uint16_t preamble = (uint16_t)regs[PREAMBLE_MSB_REG] << 8 | regs[PREAMBLE_LSB_REG];
+    if(bwIndex > 9){
+        bwIndex = 9;
+    }
+    if(sf < 6){
+        sf = 6;
+    }
+    double tSym = pow(2, sf) / bwTable[bwIndex];
+    double tPreamble = (preamble + 4.25) * tSym;
+    double num = 8.0*payloadLength - 4.0*sf + 28 + 16.0*crc - 20.0*implicitHeader;
+    double symbols = ceil(num / (4.0*(sf - 2*ldro))) * (cr + 4);
+    if(symbols < 0){
+        symbols = 0;
+    }
+    symbols += 8;
+    return (uint32_t)((tPreamble + symbols*tSym) * 1e6 + 0.5);
+}
+
+//One symbol at the current spreading factor and bandwidth
+static uint32_t symbolUs(){
+    static const uint8_t bwDivider[10] = {64, 48, 32, 24, 16, 12, 8, 4, 2, 1};
+    uint8_t bw = regs[MODEM_CONFIG_1_REG] >> 4;
+    uint8_t sf = regs[MODEM_CONFIG_2_REG] >> 4;
+    if(bw > 9){
+        bw = 9;
+    }
+    return (2UL << sf) * bwDivider[bw];
+}
+
+static uint32_t cadUs(){
+    return 2 * symbolUs();
+}
+
+//Preamble, then the 8 symbol explicit header
+static uint32_t headerUs(){
+    uint16_t preamble = (uint16_t)regs[PREAMBLE_MSB_REG] << 8 | regs[PREAMBLE_LSB_REG];
+    return (uint32_t)((preamble + 4.25 + 8) * symbolUs());
+}
+
+static void startRX(){
+    uint16_t timeout = (uint16_t)(regs[MODEM_CONFIG_2_REG] & 0x03) << 8 | regs[SYMB_TIMEOUT_LSB_REG];
+    rxPacket = downlinkLength != 0;
+    if(rxPacket){
+        rxHeaderUs = nowUs + headerUs();
+        rxEndUs = nowUs + timeOnAirUs(downlinkLength);
+    }
+    else{
+        rxEndUs = nowUs + timeout * symbolUs();
+    }
+    rxActive = 1;
+}
+
+static void endRX(){
+    rxActive = 0;
+    regs[OP_MODE_REG] = (regs[OP_MODE_REG] & 0b11111000) | STANDBY_MODE;
+    if(!rxPacket){
+        regs[IRQ_FLAGS_REG] |= IRQ_RX_TIMEOUT;
+        return;
+    }
+    uint8_t base = regs[FIFO_RX_BASE_ADDR_REG];
+    for(uint16_t i=0;i<downlinkLength;i++){
+        fifo[(uint8_t)(base + i)] = downlink[i];
+    }
+    regs[FIFO_RX_CURRENT_REG] = base;
+    regs[RX_NB_BYTES_REG] = downlinkLength;
+    regs[IRQ_FLAGS_REG] |= IRQ_RX_DONE;
+    downlinkLength = 0; //Delivered once
+    rxCount++;
+}
+
+//Applies anything that happens on its own as time passes
+static void updateTime(){
+    if(cadActive && (int32_t)(nowUs - cadEndUs) >= 0){
+        cadActive = 0;
+        regs[IRQ_FLAGS_REG] |= IRQ_CAD_DONE | (channelBusy ? IRQ_CAD_DETECTED : 0);
+        regs[OP_MODE_REG] = (regs[OP_MODE_REG] & 0b11111000) | STANDBY_MODE;
+        cadCount++;
+    }
+    if(rxActive && rxPacket && (int32_t)(nowUs - rxHeaderUs) >= 0){
+        regs[IRQ_FLAGS_REG] |= IRQ_VALID_HEADER;
+    }
+    if(rxActive && (int32_t)(nowUs - rxEndUs) >= 0){
+        endRX();
+    }
+    if(txActive && (int32_t)(nowUs - txEndUs) >= 0){
+        txActive = 0;
+        regs[IRQ_FLAGS_REG] |= IRQ_TX_DONE;
+        regs[OP_MODE_REG] = (regs[OP_MODE_REG] & 0b11111000) | STANDBY_MODE;
+        txCount++;
+    }
+}
+
+static void writeOpMode(uint8_t value){
+    uint8_t oldMode = regs[OP_MODE_REG] & 0b00000111;
+    uint8_t newMode = value & 0b00000111;
+    if(oldMode != SLEEP_MODE){
+        //LongRangeMode bit is only writable in sleep
+        value = (value & 0x7F) | (regs[OP_MODE_REG] & 0x80);
+    }
+    regs[OP_MODE_REG] = value;
+    if(oldMode == SLEEP_MODE && newMode != SLEEP_MODE){
+        oscReadyAtUs = nowUs + OSC_START_US;
+    }
+    if(newMode == SLEEP_MODE){
+        memset(fifo, 0, sizeof(fifo)); //FIFO is cleared in sleep
+        txActive = 0;
+    }
+    if(newMode == TX_MODE && !txActive){
+        lastTxLength = regs[PAYLOAD_LENGTH_REG];
+        lastTxAirUs = timeOnAirUs(lastTxLength);
+        txEndUs = nowUs + lastTxAirUs;
+        txActive = 1;
+    }
+    if(newMode != TX_MODE){
+        txActive = 0;
+    }
+    if(newMode == CAD_MODE && !cadActive){
+        cadEndUs = nowUs + cadUs();
+        cadActive = 1;
+    }
+    if(newMode != CAD_MODE){
+        cadActive = 0;
+    }
+    if(newMode == RX_SINGLE_MODE && !rxActive){
+        startRX();
+    }
+    if(newMode != RX_SINGLE_MODE){
+        rxActive = 0;
+    }
+}
+
+static void writeRegister(uint8_t reg, uint8_t value){
+    switch(reg){
+        case FIFO_REG:
+            if((regs[OP_MODE_REG] & 0b00000111) == SLEEP_MODE ||
+                    (int32_t)(nowUs - oscReadyAtUs) < 0){
+                stats.faults++; //FIFO not accessible in sleep or before the crystal has started
+            }
+            else{
+                fifo[regs[FIFO_ADD_PTR_REG]++] = value;
+            }
+            break;
+        case OP_MODE_REG:
+            writeOpMode(value);
+            break;
+        case IRQ_FLAGS_REG:
+            regs[IRQ_FLAGS_REG] &= (uint8_t)~value; //Write 1 to clear
+            break;
+        case VERSION_REG:
+            break; //Read only
+        default:
+            regs[reg] = value;
+            break;
+    }
+}
+
+static uint8_t readRegister(uint8_t reg){
+    if(reg == FIFO_REG){
+        return fifo[regs[FIFO_ADD_PTR_REG]++];
+    }
+    return regs[reg];
+}
+
+void simPowerOn(){
+    resetRegisters();
+    nowUs = 0;
+    readyAtUs = 10000; //10ms after power on
+    inReset = 0;
+    selected = 0;
+    txCount = 0;
+    lastTxLength = 0;
+    lastTxAirUs = 0;
+    channelBusy = 0;
+    cadCount = 0;
+    downlinkLength = 0;
+    rxCount = 0;
+    memset(modeUs, 0, sizeof(modeUs));
+    picSleepUs = 0;
+    memset(picAwakeUs, 0, sizeof(picAwakeUs));
+    picIdleUs = 0;
+    picHz = CLOCK_FAST_HZ; //clockInit
+    picAsleep = 0;
+    simStatsReset();
+}
+
+void simStatsReset(){
+    memset(&stats, 0, sizeof(stats));
+}
+
+SimStats simStatsGet(){
+    return stats;
+}
+
+uint32_t simNowUs(){
+    return nowUs;
+}
+
+//Time to the next thing the module does by itself, at most limit
+static uint32_t nextEventUs(uint32_t limit){
+    if(txActive && txEndUs - nowUs < limit){
+        limit = txEndUs - nowUs;
+    }
+    if(cadActive && cadEndUs - nowUs < limit){
+        limit = cadEndUs - nowUs;
+    }
+    if(rxActive && rxEndUs - nowUs < limit){
+        limit = rxEndUs - nowUs;
+    }
+    if(rxActive && rxPacket && !(regs[IRQ_FLAGS_REG] & IRQ_VALID_HEADER) &&
+            (int32_t)(rxHeaderUs - nowUs) > 0 && rxHeaderUs - nowUs < limit){
+        limit = rxHeaderUs - nowUs;
+    }
+    return limit;
+}
+
+void simAdvanceUs(uint32_t us){
+    if(!picAsleep){
+        picAwakeUs[picHz == CLOCK_FAST_HZ] += us;
+    }
+    do{
+        uint32_t step = nextEventUs(us);
+        modeUs[regs[OP_MODE_REG] & 0b00000111] += step;
+        nowUs += step;
+        us -= step;
+        updateTime();
+    } while(us);
+}
+
+uint8_t simPeekReg(uint8_t reg){
+    return regs[reg & 0x7F];
+}
+
+uint8_t simPeekFifo(uint8_t address){
+    return fifo[address];
+}
+
+uint8_t simTxCount(){
+    return txCount;
+}
+
+uint8_t simLastTxLength(){
+    return lastTxLength;
+}
+
+uint32_t simLastTxAirUs(){
+    return lastTxAirUs;
+}
+
+void simSetChannelBusy(uint8_t busy){
+    channelBusy = busy;
+}
+
+uint16_t simCadCount(){
+    return cadCount;
+}
+
+void simQueueDownlink(const uint8_t* data, uint8_t length){
+    memcpy(downlink, data, length);
+    downlinkLength = length;
+}
+
+uint16_t simRxCount(){
+    return rxCount;
+}
+
+void simSleepPic(uint32_t us){
+    picSleepUs += us;
+    picAsleep = 1;
+    simAdvanceUs(us);
+    picAsleep = 0;
+}
+
+void simIdlePic(uint32_t us){
+    picIdleUs += us;
+    picAsleep = 1; //Not running instructions either
+    simAdvanceUs(us);
+    picAsleep = 0;
+}
+
+uint64_t simPicIdleUs(){
+    return picIdleUs;
+}
+
+uint64_t simAwakeUs(uint8_t boosted){
+    return picAwakeUs[boosted != 0];
+}
+
+uint32_t simPicHz(){
+    return picHz;
+}
+
+uint64_t simModeUs(uint8_t mode){
+    return modeUs[mode & 0b00000111];
+}
+
+uint64_t simPicSleepUs(){
+    return picSleepUs;
+}
+
+uint64_t simElapsedUs(){
+    uint64_t total = 0;
+    for(uint8_t i=0;i<8;i++){
+        total += modeUs[i];
+    }
+    return total;
+}
+
+uint32_t simSpiByteUs(){
+    return 8UL * SIM_SPI_DIVIDER * 1000000UL / picHz;
+}
+
+/*
+ * LoRaHAL implementation
+ */
+
+void simDelayUs(uint32_t us){
+    stats.delayUs += us;
+    simAdvanceUs(us);
+}
+
+void LoRaHALInit(){
+    picHz = CLOCK_FAST_HZ; //clockBoost
+}
+
+void LoRaHALDisable(){
+    picHz = CLOCK_SLOW_HZ; //clockSlow
+}
+
+void LoRaHALSelect(){
+    if(inReset || (int32_t)(nowUs - readyAtUs) < 0){
+        stats.faults++; //Chip not ready yet
+    }
+    selected = 1;
+    firstByte = 1;
+    stats.transactions++;
+}
+
+void LoRaHALDeselect(){
+    selected = 0;
+}
+
+uint8_t LoRaHALTransfer(uint8_t data){
+    uint8_t result = 0;
+    stats.bytes++;
+    stats.busUs += simSpiByteUs();
+    simAdvanceUs(simSpiByteUs());
+    if(!selected){
+        stats.faults++; //Clocked with SS high, chip ignores it
+        return 0;
+    }
+    if(firstByte){
+        firstByte = 0;
+        writing = data & 0x80;
+        address = data & 0x7F;
+        return 0;
+    }
+    if(writing){
+        writeRegister(address, data);
+    }
+    else{
+        result = readRegister(address);
+    }
+    if(address != FIFO_REG){
+        address = (address + 1) & 0x7F; //Burst access auto-increments
+    }
+    return result;
+}
+
+#if LORA_DIO0_WIRED
+uint8_t LoRaHALDIO0(){
+    uint8_t flags = regs[IRQ_FLAGS_REG];
+    switch(regs[DIO_MAPPING_1_REG] & DIO0_MASK){
+        case DIO0_RX_DONE:
+            return (flags & IRQ_RX_DONE) != 0;
+        case DIO0_TX_DONE:
+            return (flags & IRQ_TX_DONE) != 0;
+        case DIO0_CAD_DONE:
+            return (flags & IRQ_CAD_DONE) != 0;
+        default:
+            return 0;
+    }
+}
+
+//Sleeps until DIO0 goes high or the watchdog, which SLEEP restarts, fires
+void LoRaHALSleep(){
+    uint32_t us = WDT_US;
+    if(LoRaHALDIO0()){
+        return;
+    }
+    if(txActive && txEndUs - nowUs < us){
+        us = txEndUs - nowUs;
+    }
+    if(cadActive && cadEndUs - nowUs < us){
+        us = cadEndUs - nowUs;
+    }
+    if(rxActive && rxPacket && rxEndUs - nowUs < us){
+        us = rxEndUs - nowUs;
+    }
+    stats.sleepUs += us;
+    simSleepPic(us);
+}
+#else
+//As LoRaHAL.c without the DIO0 link: the IRQ flags over SPI
+uint8_t LoRaHALDIO0(){
+    LoRaHALSelect();
+    LoRaHALTransfer(IRQ_FLAGS_REG);
+    uint8_t flags = LoRaHALTransfer(0);
+    LoRaHALDeselect();
+    return (flags & (IRQ_RX_DONE | IRQ_TX_DONE | IRQ_CAD_DONE)) != 0;
+}
+
+//Polls with the PIC in IDLE between reads, Timer 2 waking it
+void LoRaHALSleep(){
+    for(uint16_t polls=0;polls<DIO0_POLLS && !LoRaHALDIO0();polls++){
+        stats.sleepUs += DIO0_POLL_US;
+        simIdlePic(DIO0_POLL_US);
+    }
+}
+#endif
+
+void LoRaHALResetAssert(){
+    inReset = 1;
+}
+
+void LoRaHALResetRelease(){
+    if(inReset){
+        resetRegisters();
+        readyAtUs = nowUs + RESET_READY_US;
+    }
+    inReset = 0;
+}
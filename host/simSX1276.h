@@ -0,0 +1,51 @@
+/*
+ * File:   simSX1276.h
+ * Comments: Host-side model of the SX1276 (RFM95W) register file and SPI bus.
+ * Implements the LoRaHAL functions so LoRa.c can run on a PC.
+ * Every SPI byte and every driver delay advances a simulated clock, so the
+ * cost of each driver call can be measured without a scope.
+ */
+
+#ifndef SIMSX1276_H
+#define	SIMSX1276_H
+
+#include <stdint.h>
+
+//Bus and delay accounting since the last simStatsReset()
+typedef struct {
+    uint32_t transactions; //Number of SS assertions
+    uint32_t bytes; //Bytes clocked on the bus (address + data)
+    uint32_t busUs; //Time spent clocking bytes
+    uint32_t delayUs; //Time spent in LORA_DELAY_US/MS
+    uint32_t sleepUs; //Time the PIC spent in LoRaHALSleep
+    uint32_t faults; //Accesses the real chip would not accept (see simSX1276.c)
+} SimStats;
+
+void simPowerOn(void); //Power-on reset of the model, clock and stats
+void simStatsReset(void);
+SimStats simStatsGet(void);
+uint32_t simNowUs(void); //Simulated time since power on
+void simAdvanceUs(uint32_t); //Lets time pass without counting it as a driver delay
+
+uint8_t simPeekReg(uint8_t); //Register value without going through the bus
+uint8_t simPeekFifo(uint8_t);
+uint8_t simTxCount(void); //Packets completed since power on
+uint8_t simLastTxLength(void);
+uint32_t simLastTxAirUs(void);
+void simSetChannelBusy(uint8_t); //1 makes CAD find a preamble
+uint16_t simCadCount(void); //CADs completed since power on
+void simQueueDownlink(const uint8_t*, uint8_t); //Packet for the next RX single window, length > 0
+uint16_t simRxCount(void); //Packets received since power on
+
+void simSleepPic(uint32_t); //PIC asleep while time passes, the module carries on
+uint64_t simModeUs(uint8_t); //Time spent in an op mode (SLEEP_MODE...) since power on
+uint64_t simPicSleepUs(void); //Time the PIC has been asleep since power on
+void simIdlePic(uint32_t); //PIC in IDLE while time passes: CPU stopped, clock and peripherals running
+uint64_t simPicIdleUs(void); //Time the PIC has been in IDLE since power on
+uint64_t simElapsedUs(void); //Time since power on, without wrapping
+uint64_t simAwakeUs(uint8_t); //Time the PIC has been awake since power on, 1 at CLOCK_FAST, 0 at CLOCK_SLOW (clock.h)
+uint32_t simPicHz(void); //PIC clock now
+
+uint32_t simSpiByteUs(void); //Bus time for one byte at the configured SPI clock
+
+#endif	/* SIMSX1276_H */
@@ -0,0 +1,177 @@
+/*
+ * File:   windstats.c
+ * Checks the integer statistics in stats.c against a double precision
+ * reference.  Minutes are 30 2s counts, read as whitespace separated
+ * numbers from a file of recorded data, or generated: calm, steady and
+ * gusty winds at a range of speeds, plus a few extremes.
+ * Errors are printed in units of the last bit of each result.  Anything
+ * over ERROR_LIMIT fails, so the tool can gate a change to stats.c.
+ * Usage: windstats [-v] [-n minutes] [file]
+ *   -v  prints every minute
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../stats.h"
+#include "../wind.h"
+
+#define ERROR_LIMIT 1.0 //Last bits, allows the result's own rounding and the root's
+#define DEFAULT_MINUTES 200000
+
+typedef struct {
+    double mean;
+    double sd;
+    double gustFactor;
+    double turbulence;
+} Reference;
+
+static void reference(const uint16_t* counts, uint8_t n, Reference* r){
+    double sum = 0;
+    double max = 0;
+    double squares = 0;
+    for(uint8_t i=0;i<n;i++){
+        sum += counts[i];
+        if(counts[i] > max){
+            max = counts[i];
+        }
+    }
+    r->mean = sum/n;
+    for(uint8_t i=0;i<n;i++){
+        squares += (counts[i] - r->mean)*(counts[i] - r->mean);
+    }
+    r->sd = sqrt(squares/n);
+    r->gustFactor = sum > 0 ? max/r->mean : 0;
+    r->turbulence = sum > 0 ? r->sd/r->mean : 0;
+}
+
+//Repeatable, so a failure can be reproduced
+static uint32_t lcg = 12345;
+static double uniform(){
+    lcg = lcg*1664525UL + 1013904223UL;
+    return (lcg>>8)/16777216.0;
+}
+
+static double gaussian(){
+    double u = uniform();
+    if(u < 1e-12){
+        u = 1e-12;
+    }
+    return sqrt(-2*log(u))*cos(2*M_PI*uniform());
+}
+
+/**
+ * Makes up a minute: a random mean up to 300 counts (about 75 rev/s),
+ * turbulence up to 60%, occasional gust spikes, and every so often an
+ * extreme case.
+ */
+static void generate(uint16_t* counts, long minute){
+    double mean = 300*uniform()*uniform();
+    double turbulence = 0.6*uniform();
+    switch(minute % 50){
+        case 0:
+            memset(counts, 0, WIND_BUCKETS*sizeof(counts[0])); //Calm
+            return;
+        case 1:
+            for(uint8_t i=0;i<WIND_BUCKETS;i++){
+                counts[i] = 2047; //Steady and very fast
+            }
+            return;
+        case 2:
+            memset(counts, 0, WIND_BUCKETS*sizeof(counts[0]));
+            counts[minute % WIND_BUCKETS] = 1 + minute % 2000; //One spike
+            return;
+        case 3:
+            for(uint8_t i=0;i<WIND_BUCKETS;i++){
+                counts[i] = (i & 1) ? 2047 : 0; //Widest spread allowed
+            }
+            return;
+    }
+    for(uint8_t i=0;i<WIND_BUCKETS;i++){
+        double value = mean*(1 + turbulence*gaussian());
+        if(uniform() < 0.03){
+            value *= 2.5; //Gust
+        }
+        counts[i] = value < 0 ? 0 : (uint16_t)(value + 0.5);
+    }
+}
+
+static void usage(){
+    fprintf(stderr, "usage: windstats [-v] [-n minutes] [file]\n");
+    exit(1);
+}
+
+int main(int argc, char **argv){
+    uint16_t counts[WIND_BUCKETS];
+    double worst[4] = {0, 0, 0, 0};
+    static const char* names[4] = {"mean", "std dev", "gust factor", "turbulence"};
+    long minutes = DEFAULT_MINUTES;
+    int verbose = 0;
+    FILE* file = 0;
+    int i = 1;
+    for(;i<argc && argv[i][0] == '-';i++){
+        if(strcmp(argv[i], "-v") == 0){
+            verbose = 1;
+        }
+        else if(strcmp(argv[i], "-n") == 0 && i + 1 < argc){
+            minutes = atol(argv[++i]);
+        }
+        else{
+            usage();
+        }
+    }
+    if(i < argc){
+        file = fopen(argv[i], "r");
+        if(!file){
+            perror(argv[i]);
+            return 1;
+        }
+    }
+    long done = 0;
+    for(;file || done < minutes;done++){
+        if(file){
+            uint8_t got = 0;
+            unsigned value;
+            while(got < WIND_BUCKETS && fscanf(file, "%u", &value) == 1){
+                counts[got++] = value;
+            }
+            if(got < WIND_BUCKETS){
+                break; //Part minute at the end is left out
+            }
+        }
+        else{
+            generate(counts, done);
+        }
+        Stats stats;
+        Reference r;
+        statsReset(&stats);
+        for(uint8_t j=0;j<WIND_BUCKETS;j++){
+            statsAdd(&stats, counts[j]);
+        }
+        reference(counts, WIND_BUCKETS, &r);
+        double got[4] = {statsMean(&stats)/16.0, statsStdDev(&stats)/16.0,
+                         statsGustFactor(&stats)/256.0, statsTurbulence(&stats)/256.0};
+        double want[4] = {r.mean, r.sd, r.gustFactor, r.turbulence};
+        double unit[4] = {1/16.0, 1/16.0, 1/256.0, 1/256.0};
+        for(uint8_t k=0;k<4;k++){
+            double error = fabs(got[k] - want[k])/unit[k];
+            if(error > worst[k]){
+                worst[k] = error;
+            }
+        }
+        if(verbose){
+            printf("%6ld mean %8.3f/%8.3f sd %8.3f/%8.3f gust factor %6.3f/%6.3f turbulence %6.3f/%6.3f\n",
+                   done, got[0], want[0], got[1], want[1], got[2], want[2], got[3], want[3]);
+        }
+    }
+    if(file){
+        fclose(file);
+    }
+    int fail = 0;
+    printf("%ld minutes, worst error in last bits (fixed point against double):\n", done);
+    for(uint8_t k=0;k<4;k++){
+        printf("  %-12s %6.3f%s\n", names[k], worst[k], worst[k] > ERROR_LIMIT ? "  FAIL" : "");
+        fail |= worst[k] > ERROR_LIMIT;
+    }
+    return fail;
+}
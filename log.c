@@ -0,0 +1,81 @@
+/*
+ * File:   log.c
+ * UART1 output for printf and the trace ring.  Only built into the image
+ * when LOG_LEVEL or TRACE_SIZE turn them on (see log.h).
+ */
+#include "log.h"
+
+#if LOG_LEVEL > LOG_LEVEL_NONE && !defined(LORA_HOST_SIM)
+#include <xc.h>
+#include "defines.h"
+
+/**
+ * UART1 at 9600 baud 8N1 on TX1 (RC6) for the bench.
+ */
+void logInit(){
+    PMD0bits.UART1MD=0; //UART1 powered
+    TRISCbits.RC6=1; //TX1, the UART drives the pin
+    ANSELCbits.ANSC6=0;
+    BAUDCON1bits.BRG16=0;
+    TXSTA1bits.BRGH=1;
+    SPBRG1=(_XTAL_FREQ/16/9600)-1; //103 at 16MHz
+    TXSTA1bits.SYNC=0;
+    RCSTA1bits.SPEN=1;
+    TXSTA1bits.TXEN=1;
+}
+
+/**
+ * Called by printf for each character
+ */
+void putch(char c){
+    while(!TXSTA1bits.TRMT){
+        //Wait for the last character to go
+    }
+    TXREG1=c;
+}
+#endif
+
+#if TRACE_SIZE > 0
+#if LOG_LEVEL == LOG_LEVEL_NONE
+#include <stdio.h>
+#endif
+
+static TraceEntry trace[TRACE_SIZE];
+static uint8_t traceNext; //Next entry to write
+static uint8_t traceCount;
+static uint16_t wakeNumber;
+
+void traceEvent(uint8_t id, uint8_t arg){
+    trace[traceNext].id = id;
+    trace[traceNext].arg = arg;
+    trace[traceNext].wake = wakeNumber;
+    traceNext++;
+    if(traceNext >= TRACE_SIZE){
+        traceNext = 0;
+    }
+    if(traceCount < TRACE_SIZE){
+        traceCount++;
+    }
+}
+
+void traceWake(){
+    wakeNumber++;
+}
+
+/**
+ * Prints the entries added since the last call, oldest first, as
+ * "wake id arg" lines.  More than TRACE_SIZE in between and only the
+ * newest are left.
+ */
+void traceDump(){
+    uint8_t index = traceNext + TRACE_SIZE - traceCount;
+    for(uint8_t i=0;i<traceCount;i++){
+        if(index >= TRACE_SIZE){
+            index -= TRACE_SIZE;
+        }
+        printf("%u %u %u\r\n", trace[index].wake, trace[index].id, trace[index].arg);
+        index++;
+    }
+    traceCount = 0;
+}
+#endif
@@ -0,0 +1,101 @@
+/*
+ * File:   log.h
+ * Comments: Compile time logging and a RAM trace ring.
+ * LOG_ERROR/LOG_INFO/LOG_DEBUG take printf arguments in double brackets,
+ * LOG_DEBUG(("Reg %X\r\n", reg)), so they work without variadic macros.
+ * Anything above LOG_LEVEL compiles to nothing, so a release build doesn't
+ * link printf at all.
+ * TRACE(id, arg) stores a 4 byte record (event, argument, wake number) in a
+ * ring of TRACE_SIZE entries, much cheaper than printf on the TX path.
+ * traceDump() prints what's been added since the last dump over UART1,
+ * and main.c runs it once a minute, so the UART needs LOG_LEVEL above NONE.
+ * Both default to on in MPLAB debug builds (__DEBUG) and off otherwise;
+ * define LOG_LEVEL or TRACE_SIZE on the command line to override.
+ */
+
+#ifndef LOG_H
+#define	LOG_H
+
+#include <stdint.h>
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_INFO 2
+#define LOG_LEVEL_DEBUG 3
+
+#ifndef LOG_LEVEL
+#ifdef __DEBUG
+#define LOG_LEVEL LOG_LEVEL_DEBUG
+#else
+#define LOG_LEVEL LOG_LEVEL_NONE
+#endif
+#endif
+
+#ifndef TRACE_SIZE
+#ifdef __DEBUG
+#define TRACE_SIZE 32 //Entries, 4 bytes each
+#else
+#define TRACE_SIZE 0
+#endif
+#endif
+
+#if TRACE_SIZE > 0 && LOG_LEVEL == LOG_LEVEL_NONE && !defined(LORA_HOST_SIM)
+#error TRACE_SIZE needs LOG_LEVEL above LOG_LEVEL_NONE, traceDump prints over the log UART
+#endif
+
+#if LOG_LEVEL > LOG_LEVEL_NONE
+#include <stdio.h>
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(args) printf args
+#else
+#define LOG_ERROR(args)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(args) printf args
+#else
+#define LOG_INFO(args)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(args) printf args
+#else
+#define LOG_DEBUG(args)
+#endif
+
+//Trace event ids
+#define TRACE_LORA_START 1
+#define TRACE_LORA_MODE 2 //arg = op mode register value
+#define TRACE_TX_START 3 //arg = payload length
+#define TRACE_TX_DONE 4 //arg = watchdog wakes waited
+#define TRACE_TX_TIMEOUT 5 //arg = IRQ flags
+#define TRACE_TX_DEFERRED 6 //arg = records held back by the duty cycle governor
+#define TRACE_CAD 7 //arg = IRQ flags after channel activity detection
+#define TRACE_RX 8 //arg = IRQ flags at the end of a receive window
+#define TRACE_DOWNLINK 9 //arg = DOWNLINK_xxx result for a received command
+#define TRACE_SUPPLY 10 //arg = supplyLevel after a change
+
+typedef struct {
+    uint8_t id;
+    uint8_t arg;
+    uint16_t wake; //Wake number, see traceWake
+} TraceEntry;
+
+#if TRACE_SIZE > 0
+#define TRACE(id, arg) traceEvent(id, arg)
+void traceEvent(uint8_t, uint8_t);
+void traceWake(void); //Call once per wake to advance the trace time stamp
+void traceDump(void); //Prints the entries since the last dump, oldest first
+#else
+#define TRACE(id, arg)
+#define traceWake()
+#define traceDump()
+#endif
+
+#if LOG_LEVEL > LOG_LEVEL_NONE && !defined(LORA_HOST_SIM)
+void logInit(void); //Turns UART1 on for printf, call after shutdown()
+#else
+#define logInit()
+#endif
+
+#endif	/* LOG_H */
@@ -0,0 +1,272 @@
+/*
+ * File:   report.c
+ * Batching and sending of the wind records, see report.h.
+ * Every record goes into the EEPROM log (eelog.h) and frames are built from
+ * the log, starting at the oldest record not yet sent.  A transmission that
+ * times out leaves that point where it was, so the records go again with
+ * the next frame.
+ * The frame itself goes from reportSendTask, REPORT_SLOT_TICKS after the
+ * minute that asked for it, so nodes that power up together don't all
+ * transmit on the same tick.
+ */
+#include "report.h"
+#include "eelog.h"
+#include "duty.h"
+#include "hop.h"
+#include "settings.h"
+#include "supply.h"
+#include "downlink.h"
+#include "wind.h"
+#include "scheduler.h"
+#include "LoRa.h"
+#include "LoRaHAL.h"
+#include "log.h"
+
+static uint8_t sequence; //Of the next record
+static uint8_t firstUnsent; //Sequence number of the oldest record to send
+static uint16_t oldestTick; //schedulerNow() when firstUnsent was collected
+static WindFrame lastSent; //Reference for delta coding
+static uint8_t sinceAbsolute; //Frames since the last absolute one
+static uint8_t restartSent;
+static uint8_t flags; //Status bits for the next record
+static uint8_t sendArmed; //reportSendTask has been scheduled
+static uint8_t sendPriority;
+static uint8_t lbtTries; //Busy channels seen for this frame
+#if REPORT_LBT
+static uint16_t seed; //Backoff jitter, never 0
+#endif
+static WindFrame reference; //Last record queued, what held back minutes repeat
+static uint8_t haveReference;
+static uint8_t held; //Minutes held back just before firstUnsent
+
+/**
+ * Picks the sequence numbers up from the EEPROM log so they carry on
+ * across power cycles.
+ */
+void reportInit(){
+    sequence = eelogInit();
+    firstUnsent = sequence;
+    sinceAbsolute = 0;
+    restartSent = 0;
+    flags = 0;
+    sendArmed = 0;
+    lbtTries = 0;
+    haveReference = 0;
+    held = 0;
+#if REPORT_LBT
+    seed = 0xACE1 ^ REPORT_NODE_ID;
+#endif
+    dutyInit(schedulerNow());
+}
+
+#if REPORT_LBT
+//xorshift, stirred with awake time so nodes with the same id still differ
+static uint16_t jitter(){
+    seed ^= (uint16_t)schedulerAwake();
+    if(seed == 0){
+        seed = 0xACE1;
+    }
+    seed ^= seed<<7;
+    seed ^= seed>>9;
+    seed ^= seed<<8;
+    return seed;
+}
+#endif
+
+/**
+ * Sends up to FRAME_MAX_RECORDS of the unsent records, oldest first, in one
+ * frame.  Records missing from the log are skipped.  SPI2 is only powered
+ * for the transmission.
+ * If the duty cycle governor says no the records stay pending, and the
+ * latency bound brings them back next minute with that minute's added.
+ * Once more than the log holds are waiting the oldest are lost.
+ * With REPORT_LBT the channel is checked first and a busy one puts the
+ * frame off for a random few ticks, the range doubling each time.
+ * A frame that got out may be followed by the downlink receive window.
+ * @param priority DUTY_LOW or DUTY_HIGH
+ */
+static void sendPending(uint8_t priority){
+    WindFrame records[FRAME_MAX_RECORDS];
+    uint8_t buffer[FRAME_MAX_LENGTH];
+    uint8_t count = 0;
+    uint8_t start = firstUnsent;
+    uint8_t first = firstUnsent;
+    while((uint8_t)(start + count) != sequence && count < FRAME_MAX_RECORDS){
+        if(eelogRead(start + count, &records[count])){
+            records[count].node = REPORT_NODE_ID;
+            count++;
+        }
+        else if(count == 0){
+            start++; //Lost, carry on from the next
+        }
+        else{
+            break; //Frames hold consecutive records, the rest go next time
+        }
+    }
+    firstUnsent = start;
+    if(start != first){
+        held = 0; //They don't lead up to this record any more
+    }
+    if(count){
+        records[0].supply = supplyUnsent(); //Applies to the frame
+        records[0].held = held;
+        uint8_t useDelta = sinceAbsolute && (uint8_t)(lastSent.sequence + 1) == start;
+        uint8_t length = frameEncode(buffer, records, count, useDelta ? &lastSent : 0);
+        LoRaHALInit();
+#if HOP_ENABLE
+        LoRaSetFRF(hopFRF(REPORT_NODE_ID, start)); //Module's asleep, FRF can change
+#endif
+        uint32_t airUs = LoRaTimeOnAir(length);
+        if(!dutyAllow(schedulerNow(), airUs, priority)){
+            LoRaHALDisable();
+            TRACE(TRACE_TX_DEFERRED, count);
+            return;
+        }
+#if REPORT_LBT
+        if(LoRaCAD()){
+            LoRaSleepMode();
+            LoRaHALDisable();
+            lbtTries++;
+            if(lbtTries < REPORT_LBT_TRIES){
+                uint16_t window = (uint16_t)REPORT_LBT_BACKOFF_TICKS<<lbtTries;
+                schedulerRunIn(reportSendTask, 1 + jitter() % window);
+                sendArmed = 1;
+                sendPriority = priority;
+                return;
+            }
+            lbtTries = 0;
+            return; //Leave it pending for the next minute
+        }
+        lbtTries = 0;
+#endif
+        uint8_t wakes = airUs/(SCHED_TICK_MS*1000UL) + REPORT_TX_TIMEOUT_WAKES;
+        uint8_t sent = LoRaTXDataSleep(buffer, length, wakes);
+#if DOWNLINK_EVERY
+        if(sent){
+            downlinkListen(); //Straight away, the reply follows the frame
+        }
+#endif
+        LoRaHALDisable();
+        dutySpend(airUs); //On air even if TxDone went missing
+        if(sent){
+            firstUnsent = start + count;
+            lastSent = records[count-1];
+            held = 0;
+            if(records[0].supply){
+                supplySent();
+            }
+            sinceAbsolute++;
+            if(sinceAbsolute >= FRAME_ABSOLUTE_EVERY){
+                sinceAbsolute = 0;
+            }
+        }
+    }
+    oldestTick = schedulerNow(); //Latency starts again for what's left
+}
+
+#if REPORT_EXCEPTION
+/**
+ * A minute that needn't be sent: nothing is waiting, so it would start a
+ * frame, and the receiver can take it as a repeat of the last record
+ * queued.
+ */
+static uint8_t holdBack(const WindFrame* record){
+    if(!haveReference || record->status || firstUnsent != record->sequence ||
+            held >= REPORT_HEARTBEAT_MINUTES - 1){
+        return 0;
+    }
+    uint16_t total = record->total > reference.total ? record->total - reference.total : reference.total - record->total;
+    uint16_t gust = record->gust > reference.gust ? record->gust - reference.gust : reference.gust - record->gust;
+    return total <= REPORT_DEADBAND_TOTAL && gust <= REPORT_DEADBAND_GUST;
+}
+#endif
+
+/**
+ * Collects the last minute's pulse total and gust and sends when the batch
+ * is full, the oldest record would be held past the latency bound by the
+ * next run, or the gust is over the threshold.  With REPORT_EXCEPTION an
+ * unchanged minute is logged but not sent.
+ */
+void reportTask(){
+    WindMinute minute;
+    WindFrame record;
+    if(!windMinuteReady()){
+        return; //First run after start up
+    }
+    windGetMinute(&minute);
+    if(firstUnsent == sequence){
+        oldestTick = schedulerNow();
+    }
+    record.node = REPORT_NODE_ID;
+    record.sequence = sequence++;
+    record.total = minute.total;
+    record.gust = minute.gust;
+    record.spread = minute.spread;
+    record.status = flags | (restartSent ? 0 : FRAME_STATUS_RESTART);
+    record.supply = 0;
+    record.held = 0;
+    restartSent = 1;
+    flags = 0;
+    eelogAppend(&record);
+    uint8_t hold = 0;
+#if REPORT_EXCEPTION
+    hold = holdBack(&record);
+#endif
+    if(hold){
+        firstUnsent = sequence; //Still nothing waiting
+        held++;
+    }
+    else{
+        reference = record;
+        haveReference = 1;
+    }
+    if(reportPending() > EELOG_SLOTS){
+        firstUnsent = sequence - EELOG_SLOTS; //Older ones have been overwritten
+        held = 0;
+    }
+    uint16_t age = schedulerNow() - oldestTick;
+    uint8_t gust = !hold && minute.gust >= REPORT_GUST_SEND;
+    if(gust){
+        sendPriority = DUTY_HIGH; //Stays high if a send is already waiting
+    }
+    uint8_t batch = supplyBatchMinutes();
+    uint16_t latency = batch > REPORT_MAX_LATENCY_MINUTES ? batch : REPORT_MAX_LATENCY_MINUTES;
+    if(!hold && !sendArmed && (gust || reportPending() >= batch ||
+            age + SCHED_TICKS_PER_MINUTE >= (uint16_t)latency*SCHED_TICKS_PER_MINUTE)){
+        schedulerRunIn(reportSendTask, REPORT_SLOT_TICKS);
+        sendArmed = 1;
+    }
+    if(eelogQueued() >= EELOG_FLUSH_AT){
+        eelogFlush(); //Radio's asleep, so the writes don't add to a TX peak
+    }
+}
+
+/**
+ * Sends what's pending, in this node's slot.
+ */
+void reportSendTask(){
+    uint8_t priority = sendPriority;
+    sendArmed = 0;
+    sendPriority = DUTY_LOW;
+    sendPending(priority);
+}
+
+/**
+ * Sends the records from sequence number from onwards again, for a
+ * receiver that missed them.  They go with the next frames, oldest first.
+ * @param from
+ */
+void reportBackfill(uint8_t from){
+    if((uint8_t)(sequence - from) <= EELOG_SLOTS && (uint8_t)(sequence - from) > reportPending()){
+        firstUnsent = from;
+        held = 0; //Any held back minutes are in what goes again
+    }
+}
+
+void reportFlag(uint8_t status){
+    flags |= status;
+}
+
+uint8_t reportPending(){
+    return sequence - firstUnsent;
+}
@@ -0,0 +1,93 @@
+/*
+ * File:   report.h
+ * Comments: Turns the wind minutes into transmissions.
+ * Each minute becomes a record with the next sequence number.  Records
+ * are held in RAM and sent together in one frame (frame.h) once
+ * REPORT_BATCH_MINUTES have been collected, once the oldest has waited
+ * REPORT_MAX_LATENCY_MINUTES, or straight away when a 2s gust reaches
+ * REPORT_GUST_SEND pulses.  Every packet pays the preamble, header and
+ * radio wake up, so batching calm minutes saves most of the transmit
+ * energy.  REPORT_BATCH_MINUTES 1 sends every minute as before.
+ * Records are also kept in the EEPROM log (eelog.h).  Anything not sent,
+ * or asked for again with reportBackfill, goes out with later frames.
+ * Every frame has to get past the duty cycle governor (duty.h); gust frames
+ * may use its reserve.
+ * Frames go REPORT_SLOT_TICKS after the minute, an offset taken from the
+ * node id.  With REPORT_LBT the channel is checked with CAD first and a
+ * busy channel puts the frame off by a random number of ticks.
+ * REPORT_BATCH_MINUTES is the default for settings.batchMinutes, which a
+ * downlink command can change (downlink.h) and a low battery stretch
+ * (supply.h).  The first frame after each supply measurement carries it.
+ * With REPORT_EXCEPTION a minute is held back when nothing is waiting to
+ * go, its total and gust are within REPORT_DEADBAND_TOTAL and
+ * REPORT_DEADBAND_GUST of the last record queued and it has no status
+ * bits.  It's still logged.  The next frame gives the number held back
+ * (FRAME_STATUS_HELD) so the receiver can repeat the record before them,
+ * and still see a lost frame as a gap.  A frame goes at least every
+ * REPORT_HEARTBEAT_MINUTES, so a still night doesn't look like a dead
+ * sensor.
+ * Define any of these on the command line to override.
+ */
+
+#ifndef REPORT_H
+#define	REPORT_H
+
+#include <stdint.h>
+#include "frame.h"
+#include "scheduler.h"
+
+#ifndef REPORT_NODE_ID
+#define REPORT_NODE_ID 1 //Identifies this sensor to the receiver
+#endif
+#ifndef REPORT_BATCH_MINUTES
+#define REPORT_BATCH_MINUTES 1 //Records per packet
+#endif
+#ifndef REPORT_MAX_LATENCY_MINUTES
+#define REPORT_MAX_LATENCY_MINUTES REPORT_BATCH_MINUTES //Longest a reading waits, or the batch if that's longer
+#endif
+#ifndef REPORT_GUST_SEND
+#define REPORT_GUST_SEND 60 //Pulses in 2s, 15 rev/s, sends at once
+#endif
+#ifndef REPORT_SLOT_TICKS
+#define REPORT_SLOT_TICKS (1 + REPORT_NODE_ID % (SCHED_TICKS_PER_MINUTE - 1)) //1 to 29 ticks after the minute
+#endif
+#ifndef REPORT_LBT
+#define REPORT_LBT 0 //1 to listen before talk
+#endif
+#ifndef REPORT_EXCEPTION
+#define REPORT_EXCEPTION 1 //0 sends every minute, changed or not
+#endif
+#ifndef REPORT_DEADBAND_TOTAL
+#define REPORT_DEADBAND_TOTAL 30 //Pulses in the minute, 1/4 rev/s on the average
+#endif
+#ifndef REPORT_DEADBAND_GUST
+#define REPORT_DEADBAND_GUST 4 //Pulses in 2s, 1 rev/s on the gust
+#endif
+#ifndef REPORT_HEARTBEAT_MINUTES
+#define REPORT_HEARTBEAT_MINUTES 15 //Longest between frames when nothing changes
+#endif
+#define REPORT_LBT_TRIES 4 //Busy channels before waiting for the next minute
+#define REPORT_LBT_BACKOFF_TICKS 2 //First backoff window, doubled each try
+#define REPORT_TX_TIMEOUT_WAKES 2 //Watchdog periods to wait for TxDone on top of the time on air
+
+#if REPORT_BATCH_MINUTES < 1 || REPORT_BATCH_MINUTES > FRAME_MAX_RECORDS
+#error REPORT_BATCH_MINUTES must be 1 to FRAME_MAX_RECORDS
+#endif
+#if REPORT_SLOT_TICKS < 1 || REPORT_SLOT_TICKS >= SCHED_TICKS_PER_MINUTE
+#error REPORT_SLOT_TICKS must be 1 to SCHED_TICKS_PER_MINUTE-1
+#endif
+#if REPORT_MAX_LATENCY_MINUTES < 1
+#error REPORT_MAX_LATENCY_MINUTES must be at least 1
+#endif
+#if REPORT_HEARTBEAT_MINUTES < 1 || REPORT_HEARTBEAT_MINUTES > 100
+#error REPORT_HEARTBEAT_MINUTES must be 1 to 100, the EEPROM log (eelog.h) holds the minutes held back
+#endif
+
+void reportInit(void);
+void reportTask(void); //Scheduler task, run once a minute
+void reportSendTask(void); //Scheduler task, SCHED_ONE_SHOT
+uint8_t reportPending(void); //Records waiting to be sent
+void reportBackfill(uint8_t); //Sends the records from this sequence number again
+void reportFlag(uint8_t); //FRAME_STATUS_xxx bits for the next record
+
+#endif	/* REPORT_H */
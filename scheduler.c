@@ -0,0 +1,115 @@
+/*
+ * File:   scheduler.c
+ * Tick based cooperative scheduler, see scheduler.h.
+ * The earliest due tick over all tasks is kept in nextWake so a wake with
+ * nothing to do costs one 16 bit compare.
+ */
+#include <xc.h>
+#include "scheduler.h"
+
+static Task* taskTable;
+static uint8_t taskCount;
+static uint16_t now; //Current tick
+static uint16_t nextWake; //Earliest nextDue of all tasks
+static uint32_t awakeTotal;
+static uint16_t idleWakes;
+
+static uint16_t readTimer(){
+    uint8_t low = TMR0L; //Latches TMR0H
+    return (uint16_t)TMR0H<<8 | low;
+}
+
+static uint8_t isWaiting(Task* task){
+    return task->period != SCHED_ONE_SHOT || task->armed;
+}
+
+static void findNextWake(){
+    nextWake = now + 0x7FFF; //Nothing waiting
+    for(uint8_t i=0;i<taskCount;i++){
+        if(isWaiting(&taskTable[i]) && (int16_t)(taskTable[i].nextDue - nextWake) < 0){
+            nextWake = taskTable[i].nextDue;
+        }
+    }
+}
+
+/**
+ * Starts Timer0 for awake time profiling and runs every task on the first tick.
+ * @param tasks table, handler and period filled in
+ * @param count number of tasks, at least 1
+ */
+void schedulerInit(Task* tasks, uint8_t count){
+    T0CONbits.T08BIT=0; //16 bit
+    T0CONbits.T0CS=0; //Fosc/4, stops in sleep
+    T0CONbits.PSA=0; //Prescaler on
+    T0CONbits.T0PS=0b111; //1:256
+    T0CONbits.TMR0ON=1;
+    taskTable = tasks;
+    taskCount = count;
+    now = 0;
+    awakeTotal = 0;
+    idleWakes = 0;
+    for(uint8_t i=0;i<count;i++){
+        tasks[i].nextDue = 1;
+        tasks[i].runs = 0;
+        tasks[i].awake = 0;
+        tasks[i].armed = 0;
+    }
+    findNextWake();
+}
+
+/**
+ * Advances one tick and runs whatever is due, in table order.
+ */
+void schedulerTick(){
+    uint16_t start = readTimer();
+    now++;
+    if((int16_t)(now - nextWake) < 0){
+        idleWakes++;
+        awakeTotal += (uint16_t)(readTimer() - start);
+        return;
+    }
+    for(uint8_t i=0;i<taskCount;i++){
+        Task* task = &taskTable[i];
+        if(isWaiting(task) && (int16_t)(now - task->nextDue) >= 0){
+            uint16_t taskStart = readTimer();
+            task->nextDue = now + task->period;
+            task->armed = 0; //Before the handler, which may ask again
+            task->handler();
+            task->awake += (uint16_t)(readTimer() - taskStart);
+            task->runs++;
+        }
+    }
+    findNextWake();
+    awakeTotal += (uint16_t)(readTimer() - start);
+}
+
+/**
+ * Runs a task later, replacing any earlier request for it.  Meant for one
+ * shot tasks; a periodic task is just moved.
+ * @param handler identifies the task
+ * @param ticks from now, at least 1
+ * @return 1 if the task was found
+ */
+uint8_t schedulerRunIn(void (*handler)(void), uint16_t ticks){
+    for(uint8_t i=0;i<taskCount;i++){
+        if(taskTable[i].handler == handler){
+            taskTable[i].nextDue = now + (ticks ? ticks : 1);
+            taskTable[i].armed = 1;
+            findNextWake();
+            return 1;
+        }
+    }
+    return 0;
+}
+
+uint16_t schedulerNow(){
+    return now;
+}
+
+uint32_t schedulerAwake(){
+    return awakeTotal;
+}
+
+uint16_t schedulerIdleWakes(){
+    return idleWakes;
+}
@@ -0,0 +1,41 @@
+/*
+ * File:   scheduler.h
+ * Comments: Cooperative scheduler run from the 2s watchdog wake.
+ * Each task has a period in ticks (watchdog wakes) and is run to completion
+ * when it falls due.  schedulerTick() does nothing but a compare on wakes
+ * where no task is due, so the PIC goes straight back to SLEEP.
+ * A task with period SCHED_ONE_SHOT only runs when schedulerRunIn asks
+ * for it, once per call.
+ * Timer0 runs from Fosc/4 and stops in SLEEP, so it only counts awake time;
+ * each task's share is added to its awake counter for profiling.  The
+ * count is in instruction cycles, so with the clock switching (clock.h)
+ * it measures work rather than time.
+ */
+
+#ifndef SCHEDULER_H
+#define	SCHEDULER_H
+
+#include <stdint.h>
+
+#define SCHED_TICK_MS 2000 //Watchdog period from config.h
+#define SCHED_TICKS_PER_MINUTE 30
+#define SCHED_AWAKE_UNIT_CYCLES 256 //Timer0 count with 1:256 prescale, 64us at 16MHz, 1ms at 1MHz
+#define SCHED_ONE_SHOT 0 //Period of a task run by schedulerRunIn
+
+typedef struct {
+    void (*handler)(void);
+    uint16_t period; //Ticks between runs
+    uint16_t nextDue; //Tick number of the next run
+    uint16_t runs;
+    uint32_t awake; //Timer0 counts spent in the handler, SCHED_AWAKE_UNIT_CYCLES each
+    uint8_t armed; //One shot task waiting for nextDue
+} Task;
+
+void schedulerInit(Task*, uint8_t); //Task table and number of tasks
+void schedulerTick(void); //Call once per wake
+uint16_t schedulerNow(void); //Ticks since schedulerInit
+uint32_t schedulerAwake(void); //Timer0 counts spent in schedulerTick, all tasks included
+uint16_t schedulerIdleWakes(void); //Wakes that found nothing due
+uint8_t schedulerRunIn(void (*)(void), uint16_t); //Runs the task with this handler that many ticks from now (1 = next wake).  0 if it isn't in the table.
+
+#endif	/* SCHEDULER_H */
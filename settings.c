@@ -0,0 +1,118 @@
+/*
+ * File:   settings.c
+ * Persistent settings, see settings.h.
+ * Copy layout: version, batch minutes, spreading factor, power, downlink
+ * every, counter low, counter high, check (bit inverse of the sum of the
+ * rest).  Erased EEPROM fails the check.
+ */
+#include "settings.h"
+#include "eeprom.h"
+#include "frame.h"
+#include "report.h"
+#include "downlink.h"
+#include "supply.h"
+#include "LoRa.h"
+#include "LoRaProfile.h"
+
+#define SETTINGS_VERSION 0xA1
+#define SETTINGS_SIZE 8
+#define SETTINGS_COPIES 2
+
+Settings settings;
+
+uint8_t settingsValid(const Settings* s){
+    return s->batchMinutes >= 1 && s->batchMinutes <= FRAME_MAX_RECORDS &&
+           s->spreadingFactor >= 7 && s->spreadingFactor <= 12 &&
+           s->powerDbm >= 2 && s->powerDbm <= 17 &&
+           s->downlinkEvery >= 1;
+}
+
+/**
+ * Reads one copy.
+ * @return 1 if it's good
+ */
+static uint8_t readCopy(uint8_t copy, Settings* s){
+    uint8_t bytes[SETTINGS_SIZE];
+    uint8_t sum = 0;
+    uint16_t address = EEPROM_SETTINGS + copy*SETTINGS_SIZE;
+    for(uint8_t i=0;i<SETTINGS_SIZE;i++){
+        bytes[i] = eepromRead(address+i);
+        sum += bytes[i];
+    }
+    if(bytes[0] != SETTINGS_VERSION || sum != 0xFF){ //The last byte is the complement of the sum of the rest
+        return 0;
+    }
+    s->batchMinutes = bytes[1];
+    s->spreadingFactor = bytes[2];
+    s->powerDbm = bytes[3];
+    s->downlinkEvery = bytes[4];
+    s->downlinkCounter = (uint16_t)bytes[6]<<8 | bytes[5];
+    return settingsValid(s);
+}
+
+static void writeCopy(uint8_t copy, const Settings* s){
+    uint8_t bytes[SETTINGS_SIZE];
+    uint8_t sum = 0;
+    uint16_t address = EEPROM_SETTINGS + copy*SETTINGS_SIZE;
+    bytes[0] = SETTINGS_VERSION;
+    bytes[1] = s->batchMinutes;
+    bytes[2] = s->spreadingFactor;
+    bytes[3] = s->powerDbm;
+    bytes[4] = s->downlinkEvery;
+    bytes[5] = s->downlinkCounter & 0xFF;
+    bytes[6] = s->downlinkCounter>>8;
+    for(uint8_t i=0;i<SETTINGS_SIZE-1;i++){
+        sum += bytes[i];
+    }
+    bytes[SETTINGS_SIZE-1] = ~sum;
+    //Check byte last, so the copy only becomes valid once the rest is in
+    for(uint8_t i=0;i<SETTINGS_SIZE;i++){
+        eepromWrite(address+i, bytes[i]);
+    }
+}
+
+/**
+ * Picks the newest good copy, or the compile time defaults if neither is.
+ */
+void settingsLoad(){
+    Settings copy;
+    uint8_t found = 0;
+    settings.batchMinutes = REPORT_BATCH_MINUTES;
+    settings.spreadingFactor = LORA_SF;
+    settings.powerDbm = LORA_POWER_DBM;
+    settings.downlinkEvery = DOWNLINK_EVERY ? DOWNLINK_EVERY : 1;
+    settings.downlinkCounter = 0;
+    for(uint8_t i=0;i<SETTINGS_COPIES;i++){
+        if(readCopy(i, &copy) && (!found || (int16_t)(copy.downlinkCounter - settings.downlinkCounter) > 0)){
+            settings = copy;
+            found = 1;
+        }
+    }
+}
+
+/**
+ * Stores new settings, then makes them current.  Nothing changes if the
+ * supply is too low to write, so a command is never acted on without its
+ * counter being kept.
+ * @param s must pass settingsValid
+ * @return 1 if stored
+ */
+uint8_t settingsSave(const Settings* s){
+    if(!eepromSupplyOK()){
+        return 0;
+    }
+    for(uint8_t i=0;i<SETTINGS_COPIES;i++){
+        writeCopy(i, s);
+    }
+    settings = *s;
+    return 1;
+}
+
+/**
+ * Register writes go through the shadow, so unchanged settings cost
+ * nothing.
+ */
+void settingsApplyRadio(){
+    LoRaSetSpreadingFactor(settings.spreadingFactor);
+    LoRaSetPower(supplyPowerDbm()); //Held down on a low battery
+}
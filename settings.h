@@ -0,0 +1,31 @@
+/*
+ * File:   settings.h
+ * Comments: Settings that can be changed over the air (downlink.h) and
+ * are kept in the data EEPROM across power cycles.  Until a command has
+ * been accepted they are the compile time defaults.
+ * Two copies are written one after the other, each with a check byte, so
+ * a brown out part way through leaves at least one good.  The copy with
+ * the newer command counter wins.
+ */
+
+#ifndef SETTINGS_H
+#define	SETTINGS_H
+
+#include <stdint.h>
+
+typedef struct {
+    uint8_t batchMinutes; //Records per frame, 1 to FRAME_MAX_RECORDS
+    uint8_t spreadingFactor; //7 to 12
+    uint8_t powerDbm; //2 to 17
+    uint8_t downlinkEvery; //Transmissions per receive window, at least 1
+    uint16_t downlinkCounter; //Last command accepted, anything not newer is a replay
+} Settings;
+
+extern Settings settings;
+
+void settingsLoad(void); //From EEPROM, or the defaults
+uint8_t settingsSave(const Settings*); //Makes these the settings.  0 if the supply is too low to store them.
+uint8_t settingsValid(const Settings*); //1 if every value is in range
+void settingsApplyRadio(void); //Spreading factor and power (supply.h) to the module.  SPI2 must be on.
+
+#endif	/* SETTINGS_H */
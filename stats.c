@@ -0,0 +1,117 @@
+/*
+ * File:   stats.c
+ * Streaming statistics, see stats.h.
+ * With n samples, deviations d from the first and D = n.sum(d^2) - sum(d)^2,
+ * the standard deviation is sqrt(D)/n and the mean times n is the total.
+ * D is exact and fits 32 bits within the limits in stats.h.
+ */
+#include "stats.h"
+
+void statsReset(Stats* stats){
+    stats->count = 0;
+    stats->first = 0;
+    stats->sum = 0;
+    stats->squares = 0;
+    stats->max = 0;
+}
+
+void statsAdd(Stats* stats, uint16_t sample){
+    if(stats->count >= STATS_MAX_SAMPLES){
+        return;
+    }
+    if(stats->count == 0){
+        stats->first = sample;
+    }
+    int32_t deviation = (int32_t)sample - stats->first;
+    if(deviation > STATS_MAX_DEVIATION){
+        deviation = STATS_MAX_DEVIATION;
+    }
+    if(deviation < -STATS_MAX_DEVIATION){
+        deviation = -STATS_MAX_DEVIATION;
+    }
+    int16_t small = (int16_t)deviation;
+    stats->sum += small;
+    stats->squares += (uint32_t)((int32_t)small*small);
+    if(sample > stats->max){
+        stats->max = sample;
+    }
+    stats->count++;
+}
+
+//Sum of the samples, as clamped
+static uint32_t total(const Stats* stats){
+    return (uint32_t)((int32_t)stats->first*stats->count + stats->sum);
+}
+
+static uint16_t isqrt(uint32_t value){
+    uint32_t root = 0;
+    uint32_t bit = 1UL<<30;
+    while(bit > value){
+        bit >>= 2;
+    }
+    while(bit){
+        if(value >= root + bit){
+            value -= root + bit;
+            root = (root>>1) + bit;
+        }
+        else{
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint16_t)root;
+}
+
+/**
+ * sqrt(D) scaled up by 2^shift, D first shifted up as far as 32 bits
+ * allow so the root keeps about 15 significant bits.
+ * @param shift set to the scale used, 0 to 8
+ */
+static uint16_t scaledRoot(const Stats* stats, uint8_t* shift){
+    uint32_t n = stats->count;
+    uint32_t sum = stats->sum < 0 ? (uint32_t)-stats->sum : (uint32_t)stats->sum;
+    uint32_t d = n*stats->squares - sum*sum;
+    *shift = 0;
+    while(*shift < 8 && d < (1UL<<30)){
+        d <<= 2;
+        (*shift)++;
+    }
+    return isqrt(d);
+}
+
+uint16_t statsMean(const Stats* stats){
+    if(stats->count == 0){
+        return 0;
+    }
+    uint32_t mean = ((total(stats)<<STATS_SD_SHIFT) + stats->count/2)/stats->count;
+    return mean > 0xFFFF ? 0xFFFF : (uint16_t)mean;
+}
+
+uint16_t statsStdDev(const Stats* stats){
+    uint8_t shift;
+    if(stats->count == 0){
+        return 0;
+    }
+    uint32_t root = scaledRoot(stats, &shift);
+    uint32_t divisor = (uint32_t)stats->count<<shift;
+    return (uint16_t)(((root<<STATS_SD_SHIFT) + divisor/2)/divisor);
+}
+
+uint16_t statsGustFactor(const Stats* stats){
+    uint32_t sum = total(stats);
+    if(sum == 0){
+        return 0;
+    }
+    return (uint16_t)((((uint32_t)stats->max*stats->count<<STATS_RATIO_SHIFT) + sum/2)/sum);
+}
+
+uint16_t statsTurbulence(const Stats* stats){
+    uint8_t shift;
+    uint32_t sum = total(stats);
+    if(sum == 0){
+        return 0;
+    }
+    uint32_t root = scaledRoot(stats, &shift);
+    uint32_t divisor = sum<<shift;
+    return (uint16_t)(((root<<STATS_RATIO_SHIFT) + divisor/2)/divisor);
+}
@@ -0,0 +1,42 @@
+/*
+ * File:   stats.h
+ * Comments: Streaming statistics of the 2s pulse counts, integer only.
+ * Each sample costs a subtraction, a 16x16 multiply and two additions, and
+ * a window needs 13 bytes whatever its length.
+ * Welford's running mean needs a division per sample and rounds; with
+ * integer samples it's cheaper, and exact, to sum the deviations from the
+ * first sample and their squares (the shifted data method).  The first
+ * sample is close to the mean, so the sums stay small and there is no
+ * cancellation.  Rounding only happens in the square root at the end.
+ * Limits: STATS_MAX_SAMPLES per window and deviations from the first
+ * sample within STATS_MAX_DEVIATION (1000 rev/s, well past any anemometer),
+ * which keeps every product inside 32 bits.  Further samples are ignored
+ * and larger deviations clamped.
+ */
+
+#ifndef STATS_H
+#define	STATS_H
+
+#include <stdint.h>
+
+#define STATS_MAX_SAMPLES 32
+#define STATS_MAX_DEVIATION 2047
+#define STATS_SD_SHIFT 4 //Standard deviation and mean in 1/16 counts
+#define STATS_RATIO_SHIFT 8 //Gust factor and turbulence intensity in 1/256
+
+typedef struct {
+    uint8_t count;
+    uint16_t first; //Subtracted from every sample
+    int32_t sum; //Of the deviations
+    uint32_t squares; //Sum of the deviations squared
+    uint16_t max;
+} Stats;
+
+void statsReset(Stats*);
+void statsAdd(Stats*, uint16_t); //One 2s count
+uint16_t statsMean(const Stats*); //1/16 counts, 0xFFFF if it's over 4095
+uint16_t statsStdDev(const Stats*); //Population standard deviation, 1/16 counts
+uint16_t statsGustFactor(const Stats*); //Highest sample over the mean, 1/256.  0 with no wind.
+uint16_t statsTurbulence(const Stats*); //Standard deviation over the mean, 1/256.  0 with no wind.
+
+#endif	/* STATS_H */
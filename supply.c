@@ -0,0 +1,124 @@
+/*
+ * File:   supply.c
+ * Supply voltage measurement and the low battery policy, see supply.h.
+ * The ADC runs from its own RC clock so the conversion takes the same time
+ * whatever clock.h has the PIC on.
+ */
+#include <xc.h>
+#include "supply.h"
+#include "settings.h"
+#include "LoRaHAL.h"
+#include "log.h"
+
+static uint16_t millivolts;
+static uint8_t level;
+static uint8_t unsent;
+
+/**
+ * Converts the FVR against VDD, with the ADC and FVR powered only for as
+ * long as that takes.
+ * @return VDD in mV
+ */
+static uint16_t measure(){
+    PMD2bits.ADCMD=0; //shutdown() turned the ADC off
+    VREFCON0bits.FVRS=0b01; //1.024V
+    VREFCON0bits.FVREN=1;
+    ADCON1=0; //VDD and VSS references
+    ADCON2=0b10010111; //Right justified, 4 TAD acquisition, FRC clock
+    ADCON0bits.CHS=0b11111; //FVR buffer 2
+    ADCON0bits.ADON=1;
+    while(!VREFCON0bits.FVRST){
+        //Reference settling
+    }
+    ADCON0bits.GO=1;
+    while(ADCON0bits.GO){
+        //About 25us
+    }
+    uint16_t result = (uint16_t)ADRESH<<8 | ADRESL;
+    ADCON0bits.ADON=0;
+    VREFCON0bits.FVREN=0;
+    PMD2bits.ADCMD=1;
+    if(result == 0){
+        result = 1; //Can't happen with the FVR on, but don't divide by it
+    }
+    return (uint32_t)SUPPLY_FVR_MV*SUPPLY_ADC_FULL/result;
+}
+
+//Levels are entered at their threshold and left SUPPLY_HYSTERESIS_MV above it
+static uint8_t levelFor(uint16_t mV){
+    if(mV < SUPPLY_CRITICAL_MV ||
+            (level == SUPPLY_CRITICAL && mV < SUPPLY_CRITICAL_MV + SUPPLY_HYSTERESIS_MV)){
+        return SUPPLY_CRITICAL;
+    }
+    if(mV < SUPPLY_LOW_MV ||
+            (level != SUPPLY_OK && mV < SUPPLY_LOW_MV + SUPPLY_HYSTERESIS_MV)){
+        return SUPPLY_LOW;
+    }
+    return SUPPLY_OK;
+}
+
+void supplyInit(){
+    level = SUPPLY_OK;
+    millivolts = measure();
+    level = levelFor(millivolts);
+    unsent = 1;
+}
+
+/**
+ * Measures the supply and moves between levels.  A change of power limit
+ * goes to the module while it sleeps, it keeps its registers.
+ */
+void supplyTask(){
+    uint8_t power = supplyPowerDbm();
+    millivolts = measure();
+    unsent = 1;
+    uint8_t next = levelFor(millivolts);
+    if(next == level){
+        return;
+    }
+    level = next;
+    TRACE(TRACE_SUPPLY, level);
+    if(supplyPowerDbm() != power){
+        LoRaHALInit();
+        settingsApplyRadio();
+        LoRaHALDisable();
+    }
+}
+
+uint16_t supplyMv(){
+    return millivolts;
+}
+
+uint8_t supplyLevel(){
+    return level;
+}
+
+uint16_t supplyUnsent(){
+    return unsent ? millivolts : 0;
+}
+
+void supplySent(){
+    unsent = 0;
+}
+
+uint8_t supplyBatchMinutes(){
+    uint8_t minutes = settings.batchMinutes;
+    if(level == SUPPLY_CRITICAL && minutes < SUPPLY_CRITICAL_BATCH_MINUTES){
+        minutes = SUPPLY_CRITICAL_BATCH_MINUTES;
+    }
+    else if(level == SUPPLY_LOW && minutes < SUPPLY_LOW_BATCH_MINUTES){
+        minutes = SUPPLY_LOW_BATCH_MINUTES;
+    }
+    return minutes;
+}
+
+uint8_t supplyPowerDbm(){
+    uint8_t dBm = settings.powerDbm;
+    if(level == SUPPLY_CRITICAL && dBm > SUPPLY_CRITICAL_POWER_DBM){
+        dBm = SUPPLY_CRITICAL_POWER_DBM;
+    }
+    else if(level == SUPPLY_LOW && dBm > SUPPLY_LOW_POWER_DBM){
+        dBm = SUPPLY_LOW_POWER_DBM;
+    }
+    return dBm;
+}
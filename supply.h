@@ -0,0 +1,81 @@
+/*
+ * File:   supply.h
+ * Comments: Battery voltage, and what the sensor gives up as it falls.
+ * VDD is found by converting the 1.024V fixed voltage reference with the
+ * ADC referenced to VDD itself, so the lower the supply the bigger the
+ * reading.  The ADC and FVR are only powered for the conversion, once
+ * every SUPPLY_EVERY_MINUTES, and the result goes out with the next frame
+ * (FRAME_SUPPLY, frame.h).  The module's low battery detector
+ * (LOW_BAT_REG) is an FSK mode comparator with no reading, so isn't used.
+ * Below SUPPLY_LOW_MV frames hold at least SUPPLY_LOW_BATCH_MINUTES and
+ * go at no more than SUPPLY_LOW_POWER_DBM, below SUPPLY_CRITICAL_MV the
+ * CRITICAL pair applies.  Fewer, quieter transmissions stretch the last
+ * months of the cells instead of the node browning out (BORV, config.h)
+ * in the middle of one.  A level is only left once the supply is
+ * SUPPLY_HYSTERESIS_MV back above it, as cells recover a little when they
+ * warm up or rest.  Downlink settings (settings.h) still win where they
+ * ask for less.  Both thresholds are clear of the EEPROM write limit
+ * (eepromSupplyOK) so the log keeps working.
+ * Define any of these on the command line to override.
+ */
+
+#ifndef SUPPLY_H
+#define	SUPPLY_H
+
+#include <stdint.h>
+#include "frame.h"
+#include "scheduler.h"
+
+#ifndef SUPPLY_EVERY_MINUTES
+#define SUPPLY_EVERY_MINUTES 60 //Between measurements
+#endif
+#ifndef SUPPLY_LOW_MV
+#define SUPPLY_LOW_MV 2500 //2 x alkaline about 80% used
+#endif
+#ifndef SUPPLY_CRITICAL_MV
+#define SUPPLY_CRITICAL_MV 2300 //A few months left
+#endif
+#ifndef SUPPLY_HYSTERESIS_MV
+#define SUPPLY_HYSTERESIS_MV 50
+#endif
+#ifndef SUPPLY_LOW_BATCH_MINUTES
+#define SUPPLY_LOW_BATCH_MINUTES 5
+#endif
+#ifndef SUPPLY_LOW_POWER_DBM
+#define SUPPLY_LOW_POWER_DBM 14
+#endif
+#ifndef SUPPLY_CRITICAL_BATCH_MINUTES
+#define SUPPLY_CRITICAL_BATCH_MINUTES FRAME_MAX_RECORDS
+#endif
+#ifndef SUPPLY_CRITICAL_POWER_DBM
+#define SUPPLY_CRITICAL_POWER_DBM 10
+#endif
+#define SUPPLY_FVR_MV 1024 //FVR buffer 2 at 1x
+#define SUPPLY_ADC_FULL 1023 //10 bit result
+
+#if SUPPLY_EVERY_MINUTES < 1 || SUPPLY_EVERY_MINUTES*SCHED_TICKS_PER_MINUTE > 0xFFFF
+#error SUPPLY_EVERY_MINUTES must fit a scheduler period
+#endif
+#if SUPPLY_CRITICAL_MV >= SUPPLY_LOW_MV
+#error SUPPLY_CRITICAL_MV must be below SUPPLY_LOW_MV
+#endif
+#if SUPPLY_LOW_BATCH_MINUTES < 1 || SUPPLY_LOW_BATCH_MINUTES > FRAME_MAX_RECORDS || \
+    SUPPLY_CRITICAL_BATCH_MINUTES < 1 || SUPPLY_CRITICAL_BATCH_MINUTES > FRAME_MAX_RECORDS
+#error SUPPLY_xxx_BATCH_MINUTES must be 1 to FRAME_MAX_RECORDS
+#endif
+
+//supplyLevel results
+#define SUPPLY_OK 0
+#define SUPPLY_LOW 1
+#define SUPPLY_CRITICAL 2
+
+void supplyInit(void); //Measures straight away, so a reset with tired cells starts at the right level
+void supplyTask(void); //Scheduler task, every SUPPLY_EVERY_MINUTES
+uint16_t supplyMv(void); //Last measurement
+uint8_t supplyLevel(void);
+uint16_t supplyUnsent(void); //The measurement if it hasn't gone in a frame yet, otherwise 0
+void supplySent(void); //It has now
+uint8_t supplyBatchMinutes(void); //settings.batchMinutes, stretched for the level
+uint8_t supplyPowerDbm(void); //settings.powerDbm, held down for the level
+
+#endif	/* SUPPLY_H */
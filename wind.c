@@ -0,0 +1,108 @@
+/*
+ * File:   wind.c
+ * Timer3 pulse counting for the anemometer.
+ * The counter is never stopped or cleared: each sample is the difference
+ * from the last reading, so 16 bit wrap around doesn't matter and no pulses
+ * are lost between samples.
+ */
+#include <xc.h>
+#include "wind.h"
+#include "stats.h"
+
+static uint16_t buckets[WIND_BUCKETS];
+static uint8_t bucketIndex; //Next bucket to fill
+static uint8_t bucketsFilled; //Since the last windGetMinute, up to WIND_BUCKETS
+static uint16_t lastCount;
+static uint16_t runningTotal; //Sum of all buckets
+static Stats minuteStats; //Since the last windGetMinute
+
+static uint16_t readCounter(){
+    uint8_t low = TMR3L; //With RD16 set this also latches TMR3H
+    return (uint16_t)TMR3H<<8 | low;
+}
+
+/**
+ * Sets Timer3 up as an asynchronous counter on T3CKI (RC0, see config.h).
+ * Timer3 is one of the peripherals shutdown() turns off, so this must be
+ * called after it.
+ */
+void windInit(){
+    PMD0bits.TMR3MD=0; //Timer 3 powered
+    TRISCbits.RC0=1; //Tacho input, no analogue function on RC0
+    T3GCON=0; //No gating
+    T3CONbits.TMR3CS=0b10; //Clock from T3CKI pin
+    T3CONbits.T3CKPS=0b00; //1:1 prescale
+    T3CONbits.T3SOSCEN=0; //Secondary oscillator off, pin is a plain input
+    T3CONbits.nT3SYNC=1; //Not synchronised, so it counts in sleep
+    T3CONbits.T3RD16=1; //16 bit reads in one operation
+    TMR3H=0;
+    TMR3L=0;
+    PIE2bits.TMR3IE=0; //Overflow doesn't need to wake us
+    T3CONbits.TMR3ON=1;
+    lastCount=0;
+    bucketIndex=0;
+    bucketsFilled=0;
+    runningTotal=0;
+    statsReset(&minuteStats);
+    for(uint8_t i=0;i<WIND_BUCKETS;i++){
+        buckets[i]=0;
+    }
+}
+
+/**
+ * Stores the pulses counted since the last call in the next bucket.
+ * Called on each watchdog wake, nominally every 2 seconds.
+ */
+void windSample(){
+    uint16_t count = readCounter();
+    uint16_t pulses = count - lastCount; //Wraps correctly
+    lastCount = count;
+    runningTotal -= buckets[bucketIndex]; //Drop the bucket being overwritten
+    runningTotal += pulses;
+    buckets[bucketIndex] = pulses;
+    bucketIndex++;
+    if(bucketIndex >= WIND_BUCKETS){
+        bucketIndex = 0;
+    }
+    if(bucketsFilled < WIND_BUCKETS){
+        bucketsFilled++;
+        statsAdd(&minuteStats, pulses);
+    }
+    else{
+        //A full ring has just dropped a sample from the total (the first
+        //minute, as the wind task runs before reportTask), so start the
+        //spread again from the samples the total covers
+        statsReset(&minuteStats);
+        for(uint8_t i=0;i<WIND_BUCKETS;i++){
+            statsAdd(&minuteStats, buckets[i]);
+        }
+    }
+}
+
+uint8_t windMinuteReady(){
+    return bucketsFilled >= WIND_BUCKETS;
+}
+
+/**
+ * Gets the total, gust and spread for the last WIND_BUCKETS samples, and
+ * starts collecting the next minute.
+ * @param minute
+ */
+void windGetMinute(WindMinute* minute){
+    uint16_t gust = 0;
+    for(uint8_t i=0;i<WIND_BUCKETS;i++){
+        if(buckets[i] > gust){
+            gust = buckets[i];
+        }
+    }
+    minute->total = runningTotal;
+    minute->gust = gust;
+    minute->spread = statsStdDev(&minuteStats);
+    statsReset(&minuteStats);
+    bucketsFilled = 0;
+}
+
+uint16_t windLastBucket(){
+    uint8_t last = bucketIndex == 0 ? WIND_BUCKETS-1 : bucketIndex-1;
+    return buckets[last];
+}
@@ -0,0 +1,30 @@
+/*
+ * File:   wind.h
+ * Comments: Wind speed acquisition.  Anemometer pulses (2 per rotation) are
+ * counted by Timer3 from T3CKI on RC0, asynchronously so it keeps counting
+ * while the PIC sleeps.  The count is snapshotted on every 2s watchdog wake
+ * into a ring of 30 buckets, giving the minute total (average speed) and the
+ * highest 2s count (gust).  The counts also go through the streaming
+ * statistics in stats.h for the spread of each minute.
+ */
+
+#ifndef WIND_H
+#define	WIND_H
+
+#include <stdint.h>
+
+#define WIND_BUCKETS 30 //2s buckets in one minute
+
+typedef struct {
+    uint16_t total; //Pulses in the minute
+    uint16_t gust; //Highest 2s bucket count in the minute
+    uint16_t spread; //Standard deviation of the counts, 1/16 counts
+} WindMinute;
+
+void windInit(void); //Starts Timer3 counting.  Call after shutdown().
+void windSample(void); //Call once per watchdog wake to store the last 2s count
+uint8_t windMinuteReady(void); //1 when a full minute has been collected since the last windGetMinute
+void windGetMinute(WindMinute*); //Totals for the last 30 buckets
+uint16_t windLastBucket(void); //Count stored by the last windSample
+
+#endif	/* WIND_H */